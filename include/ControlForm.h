@@ -0,0 +1,267 @@
+/*
+  ControlForm - Decodes a post of the control page form into a FormCommand,
+  checking every value before anything is changed. The strip and sync
+  settings it holds only take effect once the device restarts with them.
+*/
+
+#ifndef ControlForm_h
+    #define ControlForm_h
+
+    #include <ctype.h>
+    #include <ESP8266WebServer.h>
+    #include <Settings.h>
+    #include <TimeSync.h>
+    #include <Utils.h>
+    #include <Lighting.h>
+
+    const size_t FORM_VALUE_MAX_LENGTH = 16u; // Longer than any valid value on the form
+
+    /**
+     * Describes how the unit keeps time with others.
+     */
+    struct SyncConfig {
+        uint8 role;
+        char leaderId[SYNC_LEADER_ID_SIZE];
+    };
+
+    /**
+     * A post of the control page form. It starts out holding the
+     * values on the page and is only used once every posted value
+     * has been decoded and found valid.
+     */
+    struct FormCommand {
+        uint action;
+        ulong delay;
+        CRGB colors[MAX_COLORS];
+        uint colorsSize;
+        StripConfig strip;
+        SyncConfig sync;
+        const char *invalidField; // The label of the first field found invalid
+    };
+
+    /**
+     * Reads a whole number made of digits alone.
+     * 
+     * @param text - The number as text.
+     * @param max - The largest number allowed.
+     * @param value - Where to put the number.
+     * 
+     * @return Returns true if a number up to max was read otherwise false as bool.
+     */
+    bool parseFormUnsigned(const char *text, ulong max, ulong &value) {
+        if (*text == '\0') {
+            return false;
+        }
+        ulong result = 0ul;
+        for (; *text != '\0'; text++) {
+            if (*text < '0' || *text > '9') {
+                return false;
+            }
+            result = (result * 10ul) + (*text - '0');
+            if (result > max) {
+                return false;
+            }
+        }
+        value = result;
+
+        return true;
+    }
+
+    /**
+     * Reads a time entered in millis, with up to three decimal places,
+     * into micros.
+     * 
+     * @param text - The time as text.
+     * @param micros - Where to put the time.
+     * 
+     * @return Returns true if a time up to MAX_STEP_MICROS was read
+     * otherwise false as bool.
+     */
+    bool parseFormMillis(const char *text, ulong &micros) {
+        const char *point = strchr(text, '.');
+        char whole[FORM_VALUE_MAX_LENGTH + 1u];
+        size_t wholeLength = (point == nullptr ? strlen(text) : (size_t) (point - text));
+        if (wholeLength > FORM_VALUE_MAX_LENGTH) {
+            return false;
+        }
+        memcpy(whole, text, wholeLength);
+        whole[wholeLength] = '\0';
+
+        ulong millis = 0ul;
+        if (!parseFormUnsigned(whole, MAX_STEP_MICROS / 1000ul, millis)) {
+            return false;
+        }
+        ulong result = millis * 1000ul;
+        if (point != nullptr) {
+            ulong scale = 100ul;
+            for (const char *digit = point + 1; *digit != '\0'; digit++) {
+                if (*digit < '0' || *digit > '9' || scale == 0ul) {
+                    return false;
+                }
+                result += (*digit - '0') * scale;
+                scale /= 10ul;
+            }
+        }
+        if (result > MAX_STEP_MICROS) {
+            return false;
+        }
+        micros = result;
+
+        return true;
+    }
+
+    /**
+     * Reads a color given as "#rrggbb", as color inputs post them.
+     * 
+     * @param text - The color as text.
+     * @param color - Where to put the color.
+     * 
+     * @return Returns true if a color was read otherwise false as bool.
+     */
+    bool parseFormColor(const char *text, CRGB &color) {
+        uint32 rgb = 0u;
+        if (text[0] != '#' || strlen(text) != 7u || !Utils::rgbHexToDecimal(&text[1], rgb)) {
+            return false;
+        }
+        color = CRGB(rgb);
+
+        return true;
+    }
+
+    /**
+     * Reads the ID of a leader to follow, which is the 6 letters and
+     * digits after Strobbie_ in the leader's network name. Spaces around
+     * it are ignored and letters are taken in either case.
+     * 
+     * @param text - The ID as text, empty when there is no leader.
+     * @param leaderId - Where to put the ID, SYNC_LEADER_ID_SIZE chars.
+     * 
+     * @return Returns true if an ID, or none, was read otherwise false as bool.
+     */
+    bool parseFormLeaderId(const char *text, char *leaderId) {
+        while (*text == ' ') {
+            text++;
+        }
+        size_t length = strlen(text);
+        while (length > 0u && text[length - 1u] == ' ') {
+            length--;
+        }
+        if (length >= SYNC_LEADER_ID_SIZE) {
+            return false;
+        }
+        for (size_t i = 0u; i < length; i++) {
+            if (!isalnum((unsigned char) text[i])) {
+                return false;
+            }
+        }
+
+        for (size_t i = 0u; i < length; i++) {
+            leaderId[i] = toupper((unsigned char) text[i]);
+        }
+        leaderId[length] = '\0';
+
+        return true;
+    }
+
+    /**
+     * Decodes a post of the control page form in a single pass over its
+     * arguments, checking each value as it goes. Arguments the form doesn't
+     * have are ignored.
+     * 
+     * @param server - The server handling the post.
+     * @param command - The FormCommand holding the current values, which is
+     * updated with those posted. The colors posted replace all of the colors
+     * so they must run from selectColor0 with none missed, if none are posted
+     * the colors are kept.
+     * 
+     * @return Returns true if every value posted was valid, otherwise false
+     * with the label of the first invalid one in command.invalidField, as bool.
+     */
+    bool decodeForm(ESP8266WebServer &server, FormCommand &command) {
+        uint colorsPosted = 0u; // A bit for each color posted
+        for (int i = 0; i < server.args(); i++) {
+            const String &name = server.argName(i);
+            const String &value = server.arg(i);
+            const char *text = value.c_str();
+            ulong number = 0ul;
+            if (value.length() > FORM_VALUE_MAX_LENGTH) {
+                command.invalidField = "A value";
+            } else if (name == "do") {
+                if (strcmp(text, "update") != 0) {
+                    command.invalidField = "Button";
+                }
+            } else if (name == "action") {
+                if (parseFormUnsigned(text, EFFECT_COUNT - 1u, number)) {
+                    command.action = number;
+                } else {
+                    command.invalidField = "Action";
+                }
+            } else if (name == "changeDelay") {
+                if (!parseFormMillis(text, command.delay)) {
+                    command.invalidField = "Change delay";
+                }
+            } else if (name.startsWith("selectColor")) {
+                uint index = name.charAt(11) - '0';
+                if (name.length() != 12u || index >= MAX_COLORS || !parseFormColor(text, command.colors[index])) {
+                    command.invalidField = "Color";
+                } else {
+                    colorsPosted |= (1u << index);
+                }
+            } else if (name == "ledCount") {
+                if (parseFormUnsigned(text, MAX_LEDS, number) && number >= 1ul) {
+                    command.strip.ledCount = number;
+                } else {
+                    command.invalidField = "LED count";
+                }
+            } else if (name == "dataPin") {
+                if (parseFormUnsigned(text, UINT8_MAX, number) && isValidDataPin(number)) {
+                    command.strip.dataPin = number;
+                } else {
+                    command.invalidField = "Data pin";
+                }
+            } else if (name == "colorOrder") {
+                if (parseFormUnsigned(text, COLOR_ORDER_COUNT - 1u, number)) {
+                    command.strip.colorOrder = number;
+                } else {
+                    command.invalidField = "Color order";
+                }
+            } else if (name == "syncRole") {
+                if (parseFormUnsigned(text, SYNC_ROLE_COUNT - 1u, number)) {
+                    command.sync.role = number;
+                } else {
+                    command.invalidField = "Sync";
+                }
+            } else if (name == "syncLeader") {
+                if (!parseFormLeaderId(text, command.sync.leaderId)) {
+                    command.invalidField = "Leader ID";
+                }
+            }
+
+            if (command.invalidField != nullptr) {
+                return false;
+            }
+        }
+
+        if (colorsPosted != 0u) {
+            uint size = 0u;
+            while (size < MAX_COLORS && (colorsPosted & (1u << size)) != 0u) {
+                size++;
+            }
+            if (colorsPosted != (1u << size) - 1u) { // A gap between colors
+                command.invalidField = "Color";
+
+                return false;
+            }
+            command.colorsSize = size;
+        }
+
+        // A follower needs the ID of its leader
+        if (command.sync.role == SYNC_FOLLOWER && command.sync.leaderId[0] == '\0') {
+            command.invalidField = "Leader ID";
+
+            return false;
+        }
+
+        return true;
+    }
+#endif
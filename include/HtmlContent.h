@@ -4,38 +4,27 @@
     #include <WString.h>
     #include <pgmspace.h>
 
-    const char PROGMEM HTML_MAIN_PAGE_TEMPLATE[] = {
-        "<!DOCTYPE html>"
-        "<html><body>"
-        "<h1>Strobbie V${appVersion}</h1>"
-        "<form action=\"/\" method=\"post\">"
-            "<label for=\"action\">Action:</label>"
-            "<select id=\"action\" name=\"action\">"
-            "<option value=\"allOff\" ${allOff_sel}>Lights Off</option>"
-            "<option value=\"solidColors\" ${solidColors_sel}>Solid Color Light</option>"
-            "<option value=\"flashingColors\" ${flashingColors_sel}>Flashing Color</option>"
-            "<option value=\"oneDirectionChase\" ${oneDirectionChase_sel}>One Direction Chase</option>"
-            "<option value=\"backAndForthChase\" ${backAndForthChase_sel}>Back & Forth Chase</option>"
-            "<option value=\"inwardChevronChase\" ${inwardChevronChase_sel}>Inward Cheveron Chase</option>"
-            "</select>"
-            "<br />"
-            "<label for=\"changeDelay\">Change delay in millis:</label>"
-            "<input type=\"number\" id=\"changeDelay\" name=\"changeDelay\" value=${changeDelay}><br />"
-            "Add another color to action: "
-            "<button type=\"submit\" name=\"do\" value=\"add\" ${add_disable}>Add</button> ${add_disableMessage}"
-            "<hr />"
-            "${selectedColors}"
-            "<br /><br /><button type=\"submit\" name=\"do\" value=\"update\">Update</button>"
-        "</form>"
-        "</body></html>"
+    /*
+     * The paths phones and computers fetch to find out whether they are
+     * online. These get a small redirect to the control page rather than
+     * the page itself, which is what makes them show it as a captive portal.
+     */
+    constexpr char CAPTIVE_PROBE_PATHS[][28] PROGMEM = {
+        "/generate_204",               // Android and Chrome
+        "/gen_204",                    // Android and Chrome
+        "/hotspot-detect.html",        // Apple
+        "/library/test/success.html",  // Apple
+        "/connecttest.txt",            // Windows
+        "/ncsi.txt",                   // Windows
+        "/redirect",                   // Windows
+        "/canonical.html",             // Firefox
+        "/success.txt",                // Firefox
+        "/check_network_status.txt",   // Linux
+        "/kindle-wifi/wifistub.html"   // Kindle
     };
+    constexpr unsigned int CAPTIVE_PROBE_PATHS_COUNT = sizeof(CAPTIVE_PROBE_PATHS) / sizeof(CAPTIVE_PROBE_PATHS[0]);
+
+    // The body of a redirect, for clients which show it rather than follow it
+    constexpr char HTML_PORTAL_REDIRECT[] PROGMEM = "<a href=\"/\">Strobbie</a>";
 
-    const char PROGMEM HTML_COLOR_SELECTION_SECTION_TEMPLATE[] = {
-        "<p>"
-        "<label for=\"selectColor${colorNumber}\">Color #${colorNumber}:</label>"
-        "<input type=\"color\" id=\"selectColor${colorNumber}\" name=\"selectColor${colorNumber}\" value=\"#${selectColor}\">"
-        "<button type=\"submit\" name=\"do\" value=\"remove:${colorNumber}\" ${remove_disable}>Remove</button>"
-        "</p>"
-        "<hr />"
-    };
 #endif
\ No newline at end of file
@@ -1,258 +1,850 @@
 #ifndef LightingEffects_h
     #define LightingEffects_h
     
-    #define NUM_LEDS 11
-    #define DATA_PIN 5
-
     #include <FastLED.h>
     #include <Utils.h>
+    #include <Ws2812Uart.h>
+    #include <Histogram.h>
+    #include <PatternVm.h>
+    #include <GradientPalette.h>
 
     const unsigned int MAX_COLORS = 3u;
+    const unsigned int MAX_LEDS = 600u;
+    const unsigned long MAX_STEP_MICROS = 60000000ul; // A minute
+
+    // WS2812B timing, 24 bits at 800KHz per LED plus the latch time
+    const unsigned long LED_MICROS = 30ul;
+    const unsigned long LATCH_MICROS = 300ul;
 
-    void doAllOff();
-    void doFlashingColors();
-    void doRotatingColorFade();
-    void doSolidColors();
-    void doOneDirectionChase();
-    void doBackAndForthChase();
-    void doTrainChase();
-    void doInwardChevronChase();
-    void doOutwardChevronChase();
-    CRGB rgbStringToColor(String rgbString, uint beginIndex);
-
-    std::map<String, void (*)()> actions {
-        {"allOff", &doAllOff},
-        {"flashingColors", &doFlashingColors},
-        {"oneDirectionChase", &doOneDirectionChase},
-        // {"rotatingColorFade", &doRotatingColorFade},
-        {"backAndForthChase", &doBackAndForthChase},
-        // {"trainChase", &doTrainChase},
-        {"inwardChevronChase", &doInwardChevronChase},
-        // {"outwardChevronChase", &doOutwardChevronChase},
-        {"solidColors", &doSolidColors}
+    // The longest an unchanged frame goes without being sent again, in case the strip glitched
+    const unsigned long FRAME_REFRESH_MICROS = 1000000ul;
+
+    /*
+     * The orders the color channels of a strip can be wired in. These
+     * are persisted in the settings so must never be renumbered.
+     */
+    enum ColorOrder : uint8 {
+        COLOR_ORDER_RGB = 0u,
+        COLOR_ORDER_RBG = 1u,
+        COLOR_ORDER_GRB = 2u,
+        COLOR_ORDER_GBR = 3u,
+        COLOR_ORDER_BRG = 4u,
+        COLOR_ORDER_BGR = 5u,
+        COLOR_ORDER_COUNT
     };
 
-    // Define the array of leds
-    CRGB leds[NUM_LEDS];
+    // Indexed by ColorOrder
+    const char COLOR_ORDER_NAMES[COLOR_ORDER_COUNT][4] PROGMEM = {"RGB", "RBG", "GRB", "GBR", "BRG", "BGR"};
 
-    // State variables
-    ulong actionDelay = 70ul;
-    void (*currentAction)() = &doFlashingColors;
-    CRGB actionColors[MAX_COLORS];
-    uint actionColorsSize = 1u;    
+    // Indexed by ColorOrder, the index into a CRGB of each channel in the order it is sent
+    const uint8 COLOR_ORDER_CHANNELS[COLOR_ORDER_COUNT][3] = {
+        {0u, 1u, 2u},
+        {0u, 2u, 1u},
+        {1u, 0u, 2u},
+        {1u, 2u, 0u},
+        {2u, 0u, 1u},
+        {2u, 1u, 0u}
+    };
 
-    void initLighting() {
-        // Initialize LEDs
-        FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
-        FastLED.clear();
-        FastLED.clearData();
+    /*
+     * The GPIOs a strip can be driven from. 6 to 11 are taken by the flash
+     * and 1 and 3 are UART0, which uploads go through. 0 and 15 are boot
+     * strapping pins that must be high and low respectively to boot from
+     * flash, which a strip's data line could upset.
+     * 16 isn't on the GPIO registers FastLED writes to. 2 is a strapping pin
+     * too, but it only needs to be high at boot, which a strip's data input
+     * leaves alone, and it is the only pin UART1 can send from.
+     */
+    const uint8 DATA_PINS[] = {2u, 4u, 5u, 12u, 13u, 14u};
+    const uint DATA_PINS_COUNT = sizeof(DATA_PINS) / sizeof(DATA_PINS[0]);
+
+    /**
+     * Describes the LED strip attached to the device.
+     */
+    struct StripConfig {
+        uint ledCount;
+        uint8 dataPin;
+        uint8 colorOrder;
+    };
+
+    /**
+     * Holds the colors that an effect draws from along with
+     * how many of them are in use.
+     */
+    struct Palette {
+        CRGB colors[MAX_COLORS];
+        uint size;
+        const uint8 *gradient; // Of the large palette, see GradientPalette, set by the EffectEngine
+    };
+
+    /**
+     * Describes the moment in time an effect is asked to render.
+     * The elapsed time is measured from when the effect was started
+     * and the step is the number of whole action delays within it,
+     * with the phase telling how far into the next step it is.
+     */
+    struct FrameTime {
+        uint64 elapsedMicros;
+        uint64 step; // Wide enough never to wrap, so effects can take it modulo anything
+        uint16 phase; // In 65536ths of a step
+    };
+
+    /**
+     * Base of all lighting effects. An effect holds no state of its own,
+     * the frame it renders is decided solely by the given time and palette,
+     * which leaves timing and output entirely to the EffectEngine.
+     */
+    class Effect {
+        public:
+            virtual ~Effect() = default;
+            virtual void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const = 0;
+    };
+
+    /**
+     * Turns off all the LEDS by settings their values to
+     * Black.
+     * 
+     */
+    class AllOffEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                for (uint i = 0u; i < numLeds; i ++) {
+                    frame[i] = CRGB::Black;
+                }
+            }
     };
 
     /**
-     * This function is used to flash the LEDs, this can be a 
+     * This effect is used to flash the LEDs, this can be a 
      * single color on and off or between any number of colors.
      * 
      */
-    void doFlashingColors() {
-        static CRGB lastColor = CRGB::Black;
-        static ulong lastChange = 0ul;
-        static ulong milliWather = 0ul;
-
-        if (millis() - lastChange >= actionDelay || milliWather > millis()) {
-            milliWather = millis();
-            CRGB nextColor;
-            // Time to do an update
-            if (actionColorsSize == 1) {
-                if (lastColor == actionColors[0]) {
-                    nextColor = CRGB::Black;
+    class FlashingColorsEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                CRGB color;
+                if (palette.size == 1u) {
+                    color = (time.step % 2ul == 0ul ? palette.colors[0] : CRGB::Black);
                 } else {
-                    nextColor = actionColors[0];
+                    color = palette.colors[time.step % palette.size];
                 }
-            } else {
-                // Find the next color from actionColors
-                bool nextFound = false;
-                for (uint i = 0u; i < actionColorsSize; i++) {
-                    if (actionColors[i] == lastColor) {
-                        nextFound = true;
-                        if (i == actionColorsSize - 1) {
-                            nextColor = actionColors[0];
-                        } else {
-                            nextColor = actionColors[(i + 1)];
-                        }
 
-                        break;
-                    }
+                for (uint i = 0u; i < numLeds; i++) {
+                    frame[i] = color;
+                }
+            }
+    };
+
+    /**
+     * Fades from one color to the next where the colors overlap some.
+     * Uses about half of the LEDs when color solid.
+     * 
+     */
+    class RotatingColorFadeEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                // TODO: Coming Soon...
+            }
+    };
+
+    /**
+     * Displays the colors chosen in a sequencial unchanging
+     * solid pattern all at once.
+     */
+    class SolidColorsEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                uint largeGroupSize = numLeds / palette.size;
+                uint smallGroupSize = largeGroupSize % palette.size == 0u ? largeGroupSize / palette.size : (largeGroupSize / palette.size) + 1u;
+                if (smallGroupSize == 0u) { // Fewer LEDs than colors...
+                    smallGroupSize = 1u;
                 }
-                if (!nextFound) {
-                    nextColor = actionColors[0];
+
+                uint colorIndex = 0u;
+                // Iterate the LEDs
+                for (uint i = 1u; i <= numLeds; i++) {
+                    // If a color group is filled and there are more colors, use next color otherwise go back to first color
+                    colorIndex = (i % smallGroupSize == 0u ? (colorIndex < palette.size - 1u ? colorIndex + 1u : 0u) : colorIndex);
+                    frame[i - 1u] = palette.colors[colorIndex];
                 }
             }
+    };
 
-            // Display the change
-            for (uint i = 0; i < NUM_LEDS; i++) {
-                leds[i] = nextColor;
+    /**
+     * Moves a single lit LED from the start of the strip to the end,
+     * switching to the next color each time it starts over.
+     */
+    class OneDirectionChaseEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                uint headIndex = time.step % numLeds;
+                uint colorIndex = (time.step / numLeds) % palette.size;
+
+                for (uint i = 0u; i < numLeds; i++) {
+                    frame[i] = (i != headIndex ? CRGB::Black : palette.colors[colorIndex]);
+                }
             }
-            FastLED.show();
+    };
 
-            // Update state
-            lastColor = nextColor;
-            lastChange = millis();
-        }
+    /**
+     * Moves a single lit LED to the end of the strip and back again,
+     * switching to the next color each time it returns to the start.
+     */
+    class BackAndForthChaseEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                ulong cycleLength = numLeds * 2ul;
+                uint cycleIndex = time.step % cycleLength;
+                uint headIndex = (cycleIndex < numLeds ? cycleIndex : cycleLength - 1u - cycleIndex);
+                uint colorIndex = (time.step / cycleLength) % palette.size;
+
+                for (uint i = 0u; i < numLeds; i++) {
+                    frame[i] = (i != headIndex ? CRGB::Black : palette.colors[colorIndex]);
+                }
+            }
+    };
+
+    class TrainChaseEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                // TODO: Coming Soon...
+            }
     };
 
     /**
-     * Fades from one color to the next where the colors overlap some.
-     * Uses about half of the LEDs when color solid.
-     * 
+     * Moves a lit LED in from each end of the strip until they
+     * meet in the middle, switching to the next color each time
+     * they start over.
+     */
+    class InwardChevronChaseEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                uint halfLength = (numLeds + 1u) / 2u;
+                uint firstIndex = time.step % halfLength;
+                uint secondIndex = numLeds - 1u - firstIndex;
+                uint colorIndex = (time.step / halfLength) % palette.size;
+
+                for (uint i = 0u; i < numLeds; i++) {
+                    frame[i] = (i == firstIndex || i == secondIndex ? palette.colors[colorIndex] : CRGB::Black);
+                }
+            }
+    };
+
+    class OutwardChevronChaseEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                // TODO: Coming Soon...
+            }
+    };
+
+    // Runs the uploaded pattern, kept here as it is loaded and replaced from outside the effect
+    PatternVm patternVm;
+
+    /**
+     * Shows the pattern uploaded to the device, see PatternVm. The
+     * LEDs stay off until a pattern is uploaded.
      */
-    void doRotatingColorFade() {
-        // TODO: Coming Soon...
+    class CustomPatternEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                patternVm.run(frame[0].raw, numLeds, time.step, time.phase, palette.colors[0].raw, palette.size);
+            }
     };
 
-    void doOneDirectionChase() {
-        static int headIndex = 0;
-        static uint currColorIndex = 0u;
-        static ulong lastChange = 0ul;
-        static ulong milliWatcher = 0ul;
-
-        if (millis() - lastChange >= actionDelay || milliWatcher > millis()) {
-            milliWatcher = millis();
-            for (uint i = 0u; i < NUM_LEDS; i++) {
-                if (headIndex < NUM_LEDS) {
-                    // Move the group forward...
-                    leds[i] = (i != headIndex ? CRGB::Black : actionColors[currColorIndex]);
-                } else {
-                    // Pick next color and reset the head...
-                    currColorIndex = (currColorIndex + 1 == actionColorsSize ? 0u : currColorIndex + 1u);
-                    headIndex = 0; 
+    // The large palette, its gradient is worked out between frames and handed to the EffectEngine
+    GradientPalette gradientPalette;
+
+    /**
+     * Scrolls a gradient along the strip, moving on by 1/256th of the
+     * gradient each step. The gradient comes from the large palette or
+     * failing that from the chosen colors.
+     */
+    class PaletteGradientEffect : public Effect {
+        public:
+            void render(CRGB *frame, uint numLeds, const FrameTime &time, const Palette &palette) const override {
+                const uint8 *gradient = palette.gradient;
+                for (uint i = 0u; i < numLeds; i++) {
+                    uint8 index = (uint8) (((i << 8) / numLeds) + time.step);
+                    if (gradient != nullptr) {
+                        frame[i] = CRGB(gradient[index * 3u], gradient[(index * 3u) + 1u], gradient[(index * 3u) + 2u]);
+                    } else {
+                        uint position = index * palette.size; // In 256ths of a color
+                        frame[i] = blend(palette.colors[position >> 8], palette.colors[((position >> 8) + 1u) % palette.size], (fract8) position);
+                    }
                 }
             }
-            headIndex ++;
-            lastChange = millis();
-            FastLED.show();
-        }
+    };
+
+    AllOffEffect allOffEffect;
+    FlashingColorsEffect flashingColorsEffect;
+    RotatingColorFadeEffect rotatingColorFadeEffect;
+    SolidColorsEffect solidColorsEffect;
+    OneDirectionChaseEffect oneDirectionChaseEffect;
+    BackAndForthChaseEffect backAndForthChaseEffect;
+    TrainChaseEffect trainChaseEffect;
+    InwardChevronChaseEffect inwardChevronChaseEffect;
+    OutwardChevronChaseEffect outwardChevronChaseEffect;
+    CustomPatternEffect customPatternEffect;
+    PaletteGradientEffect paletteGradientEffect;
+
+    /*
+     * The IDs of the effects which can be chosen. These are persisted
+     * in the settings so existing values must never be renumbered, new
+     * effects are added just before EFFECT_COUNT.
+     */
+    enum EffectId : uint8 {
+        EFFECT_ALL_OFF = 0u,
+        EFFECT_SOLID_COLORS = 1u,
+        EFFECT_FLASHING_COLORS = 2u,
+        EFFECT_ONE_DIRECTION_CHASE = 3u,
+        EFFECT_BACK_AND_FORTH_CHASE = 4u,
+        EFFECT_INWARD_CHEVRON_CHASE = 5u,
+        // EFFECT_ROTATING_COLOR_FADE,
+        // EFFECT_TRAIN_CHASE,
+        // EFFECT_OUTWARD_CHEVRON_CHASE,
+        EFFECT_CUSTOM_PATTERN = 6u,
+        EFFECT_PALETTE_GRADIENT = 7u,
+        EFFECT_COUNT
+    };
+
+    struct EffectDescriptor {
+        char name   [24];
+        char label  [24];
+    };
+
+    // Indexed by EffectId
+    const EffectDescriptor EFFECT_DESCRIPTORS[EFFECT_COUNT] PROGMEM = {
+        {"allOff", "Lights Off"},
+        {"solidColors", "Solid Color Light"},
+        {"flashingColors", "Flashing Color"},
+        {"oneDirectionChase", "One Direction Chase"},
+        {"backAndForthChase", "Back & Forth Chase"},
+        {"inwardChevronChase", "Inward Cheveron Chase"},
+        {"customPattern", "Custom Pattern"},
+        {"paletteGradient", "Palette Gradient"}
+    };
+
+    // Indexed by EffectId
+    const Effect *const EFFECTS[EFFECT_COUNT] = {
+        &allOffEffect,
+        &solidColorsEffect,
+        &flashingColorsEffect,
+        &oneDirectionChaseEffect,
+        &backAndForthChaseEffect,
+        &inwardChevronChaseEffect,
+        &customPatternEffect,
+        &paletteGradientEffect
+    };
+
+    bool isValidEffectId(uint id) {
+        return id < EFFECT_COUNT;
     }
 
-    void doBackAndForthChase() {
-        static int headIndex = -1;
-        static bool forward = true;
-        static uint currColorIndex = 0u;
-        static ulong lastChange = 0ul;
-        static ulong milliWatcher = 0ul;
-
-        if (millis() - lastChange >= actionDelay || milliWatcher > millis()) {
-            milliWatcher = millis();
-            for (uint i = 0u; i <= NUM_LEDS; i++) {
-                if ((headIndex < NUM_LEDS && forward) || (headIndex > -1 && !forward)) {
-                    // Move the group forward...
-                    leds[i] = (i != headIndex ? CRGB::Black : actionColors[currColorIndex]);
-                } else if (forward) {
-                    forward = false; 
-                } else {
-                    // Pick next color and reset the head...
-                    currColorIndex = (currColorIndex + 1 == actionColorsSize ? 0u : currColorIndex + 1u); 
-                    forward = true;
+    /**
+     * Somewhere a finished frame can be sent to. An output may still be
+     * busy sending the previous frame when the next one is ready, in which
+     * case that frame has to wait.
+     */
+    class LedOutput {
+        public:
+            virtual bool isBusy() = 0;
+            virtual void show(const CRGB *frame, uint numLeds) = 0;
+    };
+
+    /**
+     * Sends frames through FastLED, which bit-bangs them out with
+     * interrupts disabled and returns once the whole frame is sent.
+     */
+    class FastLedOutput : public LedOutput {
+        private:
+            CLEDController *controller = nullptr;
+
+        public:
+            void begin(CLEDController &controller) {
+                this->controller = &controller;
+            }
+
+            bool isBusy() override {
+                return false;
+            }
+
+            void show(const CRGB *frame, uint numLeds) override {
+                controller->setLeds((CRGB *) frame, numLeds);
+                FastLED.show();
+            }
+    };
+
+    /**
+     * Sends frames from UART1 in the background, see Ws2812Uart. This
+     * is only possible with the strip on GPIO2.
+     */
+    class UartLedOutput : public LedOutput {
+        private:
+            Ws2812Uart uart;
+            const uint8 *channelOrder = COLOR_ORDER_CHANNELS[COLOR_ORDER_GRB];
+
+        public:
+            bool begin(uint numLeds, uint8 colorOrder) {
+                channelOrder = COLOR_ORDER_CHANNELS[colorOrder];
+                
+                return uart.begin(numLeds);
+            }
+
+            bool isBusy() override {
+                return uart.isBusy();
+            }
+
+            void show(const CRGB *frame, uint numLeds) override {
+                uart.show(frame[0].raw, numLeds, channelOrder);
+            }
+    };
+
+    /**
+     * Owns the timing and output of the lighting. The engine decides
+     * when a new frame is due and asks the current effect to render it
+     * into the back buffer, which may happen while the output is still
+     * sending the front buffer. Once the output is free the buffers are
+     * swapped and the new front buffer is sent.
+     * 
+     * Changes to the effect, delay and palette are held until the next
+     * frame is started so a frame is always rendered from one set of them.
+     * A change can be faded into, for the length of the fade the old and
+     * new settings are both rendered every frame and blended together.
+     * 
+     * A rendered frame which is the same as the one last shown isn't sent,
+     * so effects which hold still, like Solid Color, leave the output and
+     * its interrupts alone other than for a refresh now and then.
+     */
+    class EffectEngine {
+        private:
+            EffectId effectId = EFFECT_ALL_OFF;
+            const Effect *effect = nullptr;
+            CRGB *front = nullptr;
+            CRGB *back = nullptr;
+            CRGB *scratch = nullptr; // Where the look being faded out of is rendered
+            uint numLeds = 0u;
+            LedOutput *output = nullptr;
+            Palette palette = {{CRGB::Black}, 1u, nullptr};
+            ulong stepMicros = 70000ul;
+            uint64 epoch = 0ull;
+            uint64 lastStep = 0ull;
+            ulong showMicros = 0ul;
+            uint32 shownHash = 0ul; // Of the frame last shown
+            uint64 lastShown = 0ull;
+            ulong unchangedFrames = 0ul;
+            Histogram renderTimes;
+            Histogram showTimes;
+            bool dirty = true;
+            bool backReady = false; // The back buffer holds a frame which is yet to be shown
+            bool external = false; // Frames come from elsewhere rather than the effect
+            bool freeRunning = false; // Effects run from time zero rather than from when they were started
+
+            // The look being faded out of, fadingEffect is nullptr when not fading
+            const Effect *fadingEffect = nullptr;
+            Palette fadingPalette = {{CRGB::Black}, 1u, nullptr};
+            ulong fadingStepMicros = 70000ul;
+            uint64 fadingEpoch = 0ull;
+            uint64 fadeStart = 0ull;
+            ulong fadeMicros = 0ul;
+
+            // Changes waiting for the next frame
+            EffectId nextEffectId = EFFECT_ALL_OFF;
+            ulong nextStepMicros = 70000ul;
+            Palette nextPalette = {{CRGB::Black}, 1u, nullptr};
+            const uint8 *nextGradient = nullptr;
+            ulong nextFadeMicros = 0ul;
+            bool effectChanged = false;
+            bool changed = false;
+
+            static FrameTime frameTimeAt(uint64 elapsedMicros, ulong stepMicros) {
+                FrameTime time;
+                time.elapsedMicros = elapsedMicros;
+                uint64 position = (elapsedMicros << 16) / (stepMicros == 0ul ? 1ul : stepMicros);
+                time.step = position >> 16;
+                time.phase = (uint16) position;
+
+                return time;
+            }
+
+            /**
+             * FNV-1a over the pixels, cheap enough to run on every frame.
+             */
+            static uint32 hashFrame(const CRGB *frame, uint numLeds) {
+                const uint8 *bytes = frame[0].raw;
+                uint32 hash = 2166136261ul;
+                for (uint i = 0u; i < numLeds * 3u; i++) {
+                    hash = (hash ^ bytes[i]) * 16777619ul;
+                }
+
+                return hash;
+            }
+
+            void applyChanges(uint64 now) {
+                if (nextFadeMicros > 0ul && effect != nullptr && scratch != nullptr) {
+                    fadingEffect = effect;
+                    fadingPalette = palette;
+                    fadingStepMicros = stepMicros;
+                    fadingEpoch = epoch;
+                    fadeStart = now;
+                    fadeMicros = nextFadeMicros;
                 }
+                nextFadeMicros = 0ul;
+                if (effectChanged) {
+                    effectId = nextEffectId;
+                    effect = EFFECTS[effectId];
+                    epoch = (freeRunning ? 0ull : now);
+                    effectChanged = false;
+                }
+                stepMicros = nextStepMicros;
+                palette = nextPalette;
+                palette.gradient = nextGradient;
+                changed = false;
+                dirty = true;
             }
-            if (forward) {
-                headIndex ++;
-            } else {
-                headIndex --;
+
+        public:
+            /**
+             * Hands the engine its frame buffers and output.
+             * 
+             * @param frames - Room for three frames of numLeds each.
+             * @param numLeds - The number of LEDs in a frame as uint.
+             * @param output - Where to send the frames.
+             */
+            void begin(CRGB *frames, uint numLeds, LedOutput *output) {
+                this->front = frames;
+                this->back = &frames[numLeds];
+                this->scratch = &frames[numLeds * 2u];
+                this->numLeds = numLeds;
+                this->output = output;
+                dirty = true;
             }
-            lastChange = millis();
-            FastLED.show();
-        }
-    }
 
-    void doTrainChase() {
+            /**
+             * Starts the given effect from its beginning.
+             * 
+             * @param effectId - The ID of the effect to render from now on,
+             * an unknown ID leaves the current effect running.
+             */
+            void setEffect(uint effectId) {
+                if (!isValidEffectId(effectId)) {
+                    return;
+                }
+                nextEffectId = (EffectId) effectId;
+                effectChanged = true;
+                changed = true;
+            }
 
-        // TODO: Coming Soon...
-    }
+            void setStepMicros(ulong stepMicros) {
+                nextStepMicros = stepMicros;
+                changed = true;
+            }
 
-    void doInwardChevronChase() {
-        static int firstIndex = 0;
-        static uint secondIndex = NUM_LEDS - 1;
-        static uint actionColorIndex = 0u;
-        static ulong lastChange = 0ul;
-        static ulong rolloverWatcher = 0ul;
+            void setPalette(const Palette &palette) {
+                nextPalette = palette;
+                changed = true;
+            }
 
-        if (millis() - lastChange >= actionDelay || rolloverWatcher > millis()) {
-            rolloverWatcher = millis();
+            /**
+             * Hands over the gradient of the large palette, which is kept
+             * apart from the colors set by setPalette().
+             * 
+             * @param gradient - GRADIENT_SIZE colors of RGB, or nullptr if
+             * there is no large palette.
+             */
+            void setGradient(const uint8 *gradient) {
+                nextGradient = gradient;
+                changed = true;
+            }
 
-            uint firstLastIndex = ((NUM_LEDS - 1) / 2u) + ((NUM_LEDS - 1) % 2u);
-            uint halfLength = firstLastIndex + 1u;
+            /**
+             * Has the next change of effect, delay or palette fade in over
+             * the given time rather than show at once. This applies to one
+             * change only, which is all the changes made before the next frame.
+             * 
+             * @param fadeMicros - The length of the fade in micros as ulong.
+             */
+            void fadeNextChange(ulong fadeMicros) {
+                nextFadeMicros = fadeMicros;
+            }
 
-            for (uint i = 0u; i <= halfLength; i++) {
-                if (firstIndex != firstLastIndex + 1) {
-                    leds[i] = (i == firstIndex ? actionColors[actionColorIndex] : CRGB::Black);
-                    uint n = NUM_LEDS - 1 - i;
-                    leds[n] = (n == secondIndex ? actionColors[actionColorIndex] : CRGB::Black);    
-                } else {
-                    firstIndex = -1;
-                    secondIndex = NUM_LEDS;
-                    actionColorIndex = (actionColorIndex < actionColorsSize - 1 ? actionColorIndex + 1 : 0u);
+            /**
+             * Has the next frame rendered even if the effect hasn't moved on
+             * a step, for when something the effect draws from has changed.
+             */
+            void refresh() {
+                dirty = true;
+            }
+
+            EffectId getEffectId() { return nextEffectId; }
+            ulong getStepMicros() { return nextStepMicros; }
+            const Palette &getPalette() { return nextPalette; }
+            uint getNumLeds() { return numLeds; }
+            ulong getShowMicros() { return showMicros; }
+            ulong getUnchangedFrames() { return unchangedFrames; }
+            bool isExternal() { return external; }
+            bool isFramePending() { return backReady; }
+            bool isFading() { return (fadingEffect != nullptr); }
+            Histogram &getRenderTimes() { return renderTimes; }
+            Histogram &getShowTimes() { return showTimes; }
+
+            /**
+             * Has effects run from time zero of the clock given to service()
+             * rather than from when they were started. Units which share a
+             * clock then show the same frame at the same time.
+             * 
+             * @param freeRunning - Whether effects run from time zero.
+             */
+            void setFreeRunning(bool freeRunning) {
+                this->freeRunning = freeRunning;
+                if (freeRunning) {
+                    epoch = 0ull;
+                }
+                dirty = true;
+            }
+
+            /**
+             * Hands over the frame to fill in place of the effect, which is
+             * paused until endExternal(). The frame starts out as the one last
+             * shown so that any part left unfilled keeps its pixels. Once it is
+             * filled pushExternalFrame() has it shown.
+             * 
+             * @return Returns the frame to fill as CRGB*.
+             */
+            CRGB *beginExternalFrame() {
+                if (!external && back != nullptr) {
+                    external = true;
+                    backReady = false;
+                    memcpy(back, front, numLeds * sizeof(CRGB));
                 }
+
+                return back;
+            }
+
+            void pushExternalFrame() {
+                backReady = true;
+            }
+
+            /**
+             * Goes back to showing the effect.
+             */
+            void endExternal() {
+                external = false;
+                backReady = false;
+                dirty = true;
+            }
+
+            /**
+             * Renders the next frame into the back buffer if the effect has
+             * advanced a step, or its settings changed, since the last frame
+             * rendered, then shows it as soon as the output is free. While
+             * frames are external the effect isn't rendered and only pushed
+             * frames are shown, as they come, never one still being
+             * filled. Steps missed while the loop was busy are skipped
+             * rather than played late. While fading every frame is
+             * rendered, as the blend moves on between steps. A rendered
+             * frame the same as the one shown is dropped unless it is due a
+             * refresh, pushed frames are always shown.
+             * 
+             * The position of the effect is worked out afresh from the time
+             * since it started for every frame, as a fixed point count of steps
+             * with 16 fractional bits. Lateness never builds up from one step to
+             * the next and steps can be shorter than a milli.
+             * 
+             * @param now - The current time in micros from a Timebase as uint64.
+             * 
+             * @return Returns true if a frame was shown otherwise false as bool.
+             */
+            bool service(uint64 now) {
+                if (output == nullptr || front == nullptr) {
+                    return false;
+                }
+
+                if (!backReady && !external) {
+                    if (changed) {
+                        applyChanges(now);
+                    }
+                    if (effect == nullptr) {
+                        return false;
+                    }
+
+                    FrameTime time = frameTimeAt(now - epoch, stepMicros);
+                    if (!dirty && time.step == lastStep && fadingEffect == nullptr) {
+                        return false;
+                    }
+
+                    ulong renderStart = micros();
+                    effect->render(back, numLeds, time, palette);
+                    if (fadingEffect != nullptr) {
+                        uint64 fadeElapsed = now - fadeStart;
+                        if (fadeElapsed >= fadeMicros) {
+                            fadingEffect = nullptr;
+                        } else {
+                            fadingEffect->render(scratch, numLeds, frameTimeAt(now - fadingEpoch, fadingStepMicros), fadingPalette);
+                            blend(scratch, back, back, numLeds, (fract8) ((fadeElapsed << 8) / fadeMicros));
+                        }
+                    }
+                    renderTimes.record(micros() - renderStart);
+                    lastStep = time.step;
+                    dirty = false;
+                    backReady = true;
+                }
+
+                if (external && !backReady) { // Only a pushed frame is whole
+                    return false;
+                }
+                if (output->isBusy()) {
+                    return false;
+                }
+
+                uint32 hash = hashFrame(back, numLeds);
+                if (!external && hash == shownHash && now - lastShown < FRAME_REFRESH_MICROS) {
+                    backReady = false;
+                    unchangedFrames++;
+
+                    return false;
+                }
+                shownHash = hash;
+                lastShown = now;
+
+                CRGB *shown = back;
+                back = front;
+                front = shown;
+                backReady = false;
+
+                ulong showStart = micros();
+                output->show(front, numLeds);
+                showMicros = micros() - showStart;
+                showTimes.record(showMicros);
+                if (external) { // The next external frame builds on this one
+                    memcpy(back, front, numLeds * sizeof(CRGB));
+                }
+
+                return true;
+            }
+    };
+
+    uint32 colorToRgb(const CRGB &color);
+
+    // The front, back and scratch frames, allocated once the strip is known
+    CRGB *frames = nullptr;
+
+    EffectEngine effectEngine;
+
+    FastLedOutput fastLedOutput;
+    UartLedOutput uartLedOutput;
+
+    bool isValidDataPin(uint pin) {
+        for (uint i = 0u; i < DATA_PINS_COUNT; i++) {
+            if (DATA_PINS[i] == pin) {
+                return true;
             }
-            firstIndex ++;
-            secondIndex --;
-            FastLED.show();
-            lastChange = millis();
         }
+
+        return false;
     }
 
-    void doOutwardChevronChase() {
-        // TODO: Coming Soon...
+    /**
+     * Checks that the given strip can be driven, anything that is
+     * out of range is replaced with a usable value.
+     * 
+     * @param strip - The StripConfig to check.
+     * 
+     * @return Returns true if nothing had to be replaced otherwise false as bool.
+     */
+    bool validateStrip(StripConfig &strip) {
+        bool ok = true;
+        if (strip.ledCount < 1u || strip.ledCount > MAX_LEDS) {
+            strip.ledCount = (strip.ledCount < 1u ? 1u : MAX_LEDS);
+            ok = false;
+        }
+        if (!isValidDataPin(strip.dataPin)) {
+            strip.dataPin = 5u;
+            ok = false;
+        }
+        if (strip.colorOrder >= COLOR_ORDER_COUNT) {
+            strip.colorOrder = COLOR_ORDER_GRB;
+            ok = false;
+        }
+
+        return ok;
     }
 
     /**
-     * Turns off all the LEDS by settings their values to
-     * Black.
+     * Gives the shortest time it takes to send a frame to a strip of the given
+     * length, this is the ceiling on the frame rate the strip can be run at.
+     * 
+     * @param ledCount - The number of LEDs in the strip as uint.
      * 
+     * @return Returns the time in micros as ulong.
      */
-    void doAllOff() {
-        for (uint i = 0u; i < MAX_COLORS; i ++) {
-            leds[i] = CRGB::Black;
+    ulong stripFrameMicros(uint ledCount) {
+        return (ledCount * LED_MICROS) + LATCH_MICROS;
+    }
+
+    /*
+     * FastLED needs the pin and color order at compile time, so there is
+     * a controller for each combination and the strip picks one at boot.
+     */
+    template <uint8 PIN>
+    CLEDController &addStrip(uint8 colorOrder, CRGB *leds, uint ledCount) {
+        switch (colorOrder) {
+            case COLOR_ORDER_RGB: return FastLED.addLeds<WS2812B, PIN, RGB>(leds, ledCount);
+            case COLOR_ORDER_RBG: return FastLED.addLeds<WS2812B, PIN, RBG>(leds, ledCount);
+            case COLOR_ORDER_GBR: return FastLED.addLeds<WS2812B, PIN, GBR>(leds, ledCount);
+            case COLOR_ORDER_BRG: return FastLED.addLeds<WS2812B, PIN, BRG>(leds, ledCount);
+            case COLOR_ORDER_BGR: return FastLED.addLeds<WS2812B, PIN, BGR>(leds, ledCount);
+            default: return FastLED.addLeds<WS2812B, PIN, GRB>(leds, ledCount);
         }
-        FastLED.show();
-    };
+    }
 
     /**
-     * Displays the colors chosen in a sequencial unchanging
-     * solid pattern all at once.
+     * Allocates the LEDs and sets up the output for the given strip.
+     * This may only be called once, the strip is fixed until reboot.
+     * A strip on GPIO2 is driven from UART1 so that sending a frame
+     * doesn't hold up the loop, the others go through FastLED.
+     * 
+     * @param strip - The StripConfig of the attached strip.
      */
-    void doSolidColors() {
-        uint largeGroupSize = NUM_LEDS / actionColorsSize;
-        uint smallGroupSize = largeGroupSize % actionColorsSize == 0u ? largeGroupSize / actionColorsSize : (largeGroupSize / actionColorsSize) + 1u;
-
-        uint colorIndex = 0u;
-        // Iterate the LEDs
-        for (uint i = 1u; i <= NUM_LEDS; i++) {
-            // If a color group is filled and there are more colors, use next color otherwise go back to first color
-            colorIndex = (i % smallGroupSize == 0u ? (colorIndex < actionColorsSize - 1u ? colorIndex + 1u : 0u) : colorIndex);
-            leds[i - 1u] = actionColors[colorIndex];
+    void initLighting(StripConfig strip) {
+        validateStrip(strip);
+        frames = new CRGB[strip.ledCount * 3u];
+        for (uint i = 0u; i < strip.ledCount * 3u; i++) {
+            frames[i] = CRGB::Black;
         }
-        FastLED.show();
+
+        if (strip.dataPin == WS2812_UART_PIN && uartLedOutput.begin(strip.ledCount, strip.colorOrder)) {
+            uartLedOutput.show(frames, strip.ledCount);
+            effectEngine.begin(frames, strip.ledCount, &uartLedOutput);
+
+            return;
+        }
+
+        // Initialize LEDs
+        CLEDController *controller;
+        switch (strip.dataPin) {
+            case 2u: controller = &addStrip<2u>(strip.colorOrder, frames, strip.ledCount); break;
+            case 4u: controller = &addStrip<4u>(strip.colorOrder, frames, strip.ledCount); break;
+            case 12u: controller = &addStrip<12u>(strip.colorOrder, frames, strip.ledCount); break;
+            case 13u: controller = &addStrip<13u>(strip.colorOrder, frames, strip.ledCount); break;
+            case 14u: controller = &addStrip<14u>(strip.colorOrder, frames, strip.ledCount); break;
+            default: controller = &addStrip<5u>(strip.colorOrder, frames, strip.ledCount); break;
+        }
+        FastLED.clear(true);
+        fastLedOutput.begin(*controller);
+
+        effectEngine.begin(frames, strip.ledCount, &fastLedOutput);
     };
 
     /**
      * UTILITY FUNCTION
      * ----------------
-     * This is a utility function which converts a RGB String to a CRGB color object.
-     * This method allows for a begin index to be supplied which determines where 
-     * parsing of the color hex digits begins in the given string. This can be useful
-     * particularly when working with color codes that begin with a '#'.
+     * Packs the given color into a single value of the form 0xRRGGBB.
      * 
-     * @param rgbString - The RGB hex code as a String.
-     * @param beginIndex - The index from which to begin parsing the RGB hex code as uint.
+     * @param color - The color to pack as CRGB.
+     * 
+     * @return Returns the packed color as uint32.
      */
-    CRGB rgbStringToColor(String rgbString, uint beginIndex) {
-        uint8 red = Utils::hexTo8BitDecimal(rgbString.substring(beginIndex, beginIndex + 2));
-        uint8 green = Utils::hexTo8BitDecimal(rgbString.substring(beginIndex + 2, beginIndex + 4));
-        uint8 blue = Utils::hexTo8BitDecimal(rgbString.substring(beginIndex + 4, beginIndex + 6));
-                
-        CRGB color; 
-        color.setRGB(red, green, blue);
-
-        return color;
+    uint32 colorToRgb(const CRGB &color) {
+        return ((uint32) color.red << 16) | ((uint32) color.green << 8) | color.blue;
     };
 #endif
\ No newline at end of file
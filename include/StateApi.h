@@ -0,0 +1,146 @@
+/*
+  StateApi - Reads and changes the running state as small JSON objects for
+  /api/state. Both ways are fixed size and built on the stack, nothing is
+  allocated for them.
+*/
+
+#ifndef StateApi_h
+    #define StateApi_h
+
+    #include <ESP8266WebServer.h>
+    #include <JsonReader.h>
+    #include <Utils.h>
+    #include <Lighting.h>
+
+    const size_t API_STATE_JSON_SIZE = 192u; // Fits the longest state with room to spare
+
+    /**
+     * Sends the given JSON as the whole response, with its length
+     * given up front so the client needn't wait for the connection
+     * to close.
+     *
+     * @param server - The server handling the request.
+     * @param code - The HTTP status code.
+     * @param json - The JSON to send.
+     * @param length - The length of the JSON.
+     */
+    void sendJson(ESP8266WebServer &server, int code, const char *json, size_t length) {
+        server.setContentLength(length);
+        server.send(code, "application/json", "");
+        server.sendContent(json, length);
+    }
+
+    /**
+     * Reads a color given as a "#rrggbb" string.
+     *
+     * @param reader - The JsonReader to read the color from.
+     * @param color - Where to put the color.
+     *
+     * @return Returns true if a valid color was read otherwise false as bool.
+     */
+    bool readApiColor(JsonReader &reader, CRGB &color) {
+        char hex[8];
+        uint32 rgb = 0u;
+        if (!reader.readString(hex, sizeof(hex)) || hex[0] != '#' || strlen(hex) != 7u || !Utils::rgbHexToDecimal(&hex[1], rgb)) {
+            return false;
+        }
+        color = CRGB(rgb);
+
+        return true;
+    }
+
+    /**
+     * Writes the current state as JSON.
+     *
+     * @param strip - The strip in use.
+     * @param json - Where to write the JSON.
+     * @param size - The room for the JSON, API_STATE_JSON_SIZE is enough.
+     *
+     * @return Returns the length of the JSON as size_t.
+     */
+    size_t formatStateJson(const StripConfig &strip, char *json, size_t size) {
+        const Palette &palette = effectEngine.getPalette();
+        int length = snprintf(json, size, "{\"action\":%u,\"delayMicros\":%lu,\"colors\":[", (uint) effectEngine.getEffectId(), effectEngine.getStepMicros());
+        for (uint i = 0u; i < palette.size; i++) {
+            char hex[7];
+            Utils::rgbDecimalToHex(colorToRgb(palette.colors[i]), hex);
+            length += snprintf(&json[length], size - length, "%s\"#%s\"", (i == 0u ? "" : ","), hex);
+        }
+        length += snprintf(&json[length], size - length, "],\"ledCount\":%u,\"dataPin\":%u,\"colorOrder\":%u}", strip.ledCount, (uint) strip.dataPin, (uint) strip.colorOrder);
+
+        return length;
+    }
+
+    /**
+     * Sends the current state as JSON, for example:
+     * {"action":2,"delayMicros":70000,"colors":["#0000ff"],"ledCount":11,"dataPin":5,"colorOrder":2}
+     *
+     * @param server - The server handling the request.
+     * @param strip - The strip in use.
+     */
+    void sendState(ESP8266WebServer &server, const StripConfig &strip) {
+        char json[API_STATE_JSON_SIZE];
+        sendJson(server, 200, json, formatStateJson(strip, json, sizeof(json)));
+    }
+
+    /**
+     * Changes part of the state from a JSON object holding any of:
+     * "action" and "delayMicros" as numbers, "colors" as an array of
+     * one to three "#rrggbb" strings which replaces all of the colors,
+     * or "color0" to "color2" as a "#rrggbb" string which replaces just
+     * that color. Nothing is changed unless the whole object is valid.
+     * The change is applied from the next frame and the new state is
+     * sent back. Saving it is left to the caller.
+     *
+     * @param server - The server handling the request, the body is the object.
+     * @param strip - The strip in use.
+     *
+     * @return Returns true if the state was changed otherwise false, after
+     * sending a 400, as bool.
+     */
+    bool patchState(ESP8266WebServer &server, const StripConfig &strip) {
+        uint action = effectEngine.getEffectId();
+        ulong delay = effectEngine.getStepMicros();
+        Palette palette = effectEngine.getPalette();
+
+        const String &body = server.arg("plain");
+        JsonReader reader(body.c_str());
+        char key[16];
+        bool ok = reader.beginObject();
+        while (ok && reader.nextKey(key, sizeof(key))) {
+            if (strcmp(key, "action") == 0) {
+                ulong value = 0ul;
+                ok = reader.readUnsigned(value) && isValidEffectId(value);
+                action = value;
+            } else if (strcmp(key, "delayMicros") == 0) {
+                ok = reader.readUnsigned(delay) && delay <= MAX_STEP_MICROS;
+            } else if (strcmp(key, "colors") == 0) {
+                palette.size = 0u;
+                ok = reader.beginArray();
+                while (ok && reader.nextItem()) {
+                    ok = palette.size < MAX_COLORS && readApiColor(reader, palette.colors[palette.size++]);
+                }
+                ok = ok && !reader.hasFailed() && palette.size > 0u;
+            } else if (strncmp(key, "color", 5u) == 0 && key[5] >= '0' && key[5] < (char) ('0' + MAX_COLORS) && key[6] == '\0') {
+                ok = readApiColor(reader, palette.colors[key[5] - '0']);
+            } else { // Unknown key
+                ok = false;
+            }
+        }
+        if (!ok || !reader.end()) {
+            const char error[] = "{\"error\":\"Invalid state\"}";
+            sendJson(server, 400, error, sizeof(error) - 1u);
+
+            return false;
+        }
+
+        effectEngine.setStepMicros(delay);
+        effectEngine.setPalette(palette);
+        if (action != effectEngine.getEffectId()) {
+            effectEngine.setEffect(action);
+        }
+        sendState(server, strip);
+
+        return true;
+    }
+#endif
@@ -0,0 +1,134 @@
+/*
+  WebAssets - The static files of the web UI, gzipped. Generated from
+  web/ by tools/compress_web.py before each build, do not edit.
+*/
+
+#ifndef WebAssets_h
+    #define WebAssets_h
+
+    #include <stddef.h>
+    #include <pgmspace.h>
+
+    // web/index.html, 4831 bytes before compression
+    const char INDEX_HTML_ETAG[] = "\"3844219adc17665f\"";
+    const size_t INDEX_HTML_GZ_SIZE = 1861u;
+    const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x58, 0x6d, 0x6f, 0xdb, 0x36,
+        0x10, 0xfe, 0x9e, 0x5f, 0x71, 0x73, 0x8b, 0x49, 0xea, 0x5c, 0x29, 0x6e, 0xd7, 0x22, 0x48, 0x6c,
+        0x0f, 0x59, 0x92, 0x6e, 0x01, 0x92, 0x25, 0x48, 0xda, 0x0e, 0x43, 0x90, 0x0f, 0xb4, 0x44, 0x47,
+        0x5c, 0xf5, 0x36, 0x91, 0xb2, 0x6b, 0x0c, 0xfd, 0xef, 0xbb, 0x23, 0x29, 0x89, 0x76, 0x94, 0xa0,
+        0x2b, 0xd2, 0x88, 0x2f, 0x47, 0xde, 0xf1, 0xb9, 0x87, 0x77, 0xc7, 0x4c, 0x7f, 0x38, 0xbd, 0x3a,
+        0xf9, 0xf8, 0xd7, 0xf5, 0x19, 0xa4, 0x2a, 0xcf, 0xe6, 0x7b, 0xd3, 0xf6, 0xc3, 0x59, 0x82, 0x9f,
+        0x9c, 0x2b, 0x06, 0x71, 0xca, 0x6a, 0xc9, 0xd5, 0x6c, 0xd4, 0xa8, 0xe5, 0xeb, 0x83, 0x51, 0x3b,
+        0x5c, 0xb0, 0x9c, 0xcf, 0x46, 0x2b, 0xc1, 0xd7, 0x55, 0x59, 0xab, 0x11, 0xc4, 0x65, 0xa1, 0x78,
+        0x81, 0x62, 0x6b, 0x91, 0xa8, 0x74, 0x96, 0xf0, 0x95, 0x88, 0xf9, 0x6b, 0xdd, 0x19, 0x83, 0x28,
+        0x84, 0x12, 0x2c, 0x7b, 0x2d, 0x63, 0x96, 0xf1, 0xd9, 0x84, 0x36, 0x51, 0x42, 0x65, 0x7c, 0x7e,
+        0xab, 0xea, 0x72, 0xb1, 0x10, 0x7c, 0x1a, 0x99, 0xfe, 0xde, 0x34, 0xb2, 0xba, 0x17, 0x65, 0xb2,
+        0x21, 0x4b, 0x26, 0x9d, 0x0c, 0x7c, 0x9e, 0xca, 0x8a, 0x15, 0x20, 0x12, 0xd4, 0xcb, 0x6b, 0x29,
+        0xca, 0x62, 0x34, 0x9f, 0x46, 0x34, 0x86, 0x1f, 0x14, 0xdc, 0x9b, 0x56, 0x7a, 0x32, 0xe7, 0x52,
+        0xb2, 0x07, 0x4e, 0x93, 0x15, 0x0e, 0x2e, 0xcb, 0x3a, 0x07, 0x16, 0x2b, 0x94, 0x9f, 0x8d, 0xa2,
+        0x11, 0xa0, 0xf9, 0x69, 0x89, 0x62, 0x55, 0x29, 0x15, 0x5a, 0x02, 0x30, 0xcd, 0xd8, 0x82, 0x67,
+        0x80, 0x72, 0xb3, 0x91, 0x91, 0x1b, 0xcd, 0x8f, 0xf5, 0xf7, 0x70, 0x1a, 0xe9, 0x39, 0x2d, 0x25,
+        0x79, 0xc6, 0x63, 0xa5, 0x35, 0x58, 0x29, 0x0b, 0x42, 0xbb, 0x06, 0x6d, 0xd1, 0x22, 0x5a, 0x7a,
+        0x51, 0x43, 0xb4, 0xbb, 0x39, 0x42, 0x59, 0x3c, 0xf0, 0x53, 0x9e, 0xb1, 0xcd, 0x68, 0x7e, 0xa2,
+        0x3b, 0x90, 0x50, 0x0f, 0x01, 0x82, 0x5c, 0x64, 0x99, 0x90, 0x5b, 0x1a, 0x45, 0x51, 0x35, 0x0a,
+        0xd4, 0xa6, 0x42, 0x25, 0x45, 0x93, 0x2f, 0x78, 0x3d, 0xd2, 0xea, 0xdd, 0x7d, 0xac, 0x0d, 0x5b,
+        0x43, 0xb9, 0xc0, 0x93, 0xee, 0x8f, 0x40, 0x2a, 0x5e, 0x61, 0x23, 0xdc, 0xdf, 0x47, 0xc8, 0x3b,
+        0x8b, 0x8e, 0x93, 0x04, 0x58, 0x51, 0xaa, 0x94, 0xd7, 0xe8, 0xb5, 0xac, 0xac, 0x41, 0x95, 0x16,
+        0x9f, 0x43, 0x6d, 0x79, 0xa3, 0x54, 0x59, 0x58, 0xb5, 0xa6, 0x63, 0xd4, 0xb2, 0x24, 0x41, 0x60,
+        0x92, 0x64, 0x1a, 0x99, 0xd1, 0x39, 0xf4, 0x0e, 0xc1, 0xb9, 0xcb, 0x1e, 0x76, 0xed, 0x13, 0xda,
+        0x2b, 0x6d, 0x51, 0x48, 0xc4, 0xca, 0x98, 0x4e, 0x0a, 0x25, 0xc9, 0xe0, 0xc8, 0x2e, 0x3e, 0x19,
+        0x4f, 0x4e, 0xca, 0xa6, 0x40, 0xaf, 0x5c, 0x9c, 0x9d, 0xa2, 0x6d, 0xd8, 0xfc, 0x2e, 0x3c, 0xba,
+        0x75, 0x16, 0x8c, 0xbe, 0xaf, 0x91, 0x70, 0x0f, 0xef, 0xaa, 0x4b, 0x98, 0x62, 0xd7, 0x02, 0x1d,
+        0x77, 0x8a, 0x0d, 0xa8, 0xc4, 0x93, 0xee, 0x6e, 0x05, 0xed, 0xf6, 0xdd, 0xba, 0xce, 0xe1, 0xc3,
+        0xde, 0xa6, 0xa3, 0x5e, 0xd5, 0x09, 0x5a, 0x39, 0x3f, 0xd1, 0x38, 0x97, 0xd4, 0x79, 0x4a, 0x89,
+        0x23, 0xde, 0xfa, 0xd4, 0xd9, 0xa0, 0x53, 0xe5, 0x60, 0x2e, 0x55, 0x2d, 0xaa, 0x67, 0x51, 0x77,
+        0xac, 0x91, 0x9b, 0x22, 0xbe, 0x29, 0x33, 0x14, 0xbc, 0xc5, 0x16, 0xac, 0x85, 0x4a, 0xc1, 0x70,
+        0xa0, 0xc1, 0xcb, 0x29, 0xc1, 0x57, 0xa9, 0x90, 0x80, 0x3f, 0xfd, 0xfe, 0xe6, 0x0e, 0x9f, 0x27,
+        0xdd, 0xde, 0xc1, 0x53, 0xb6, 0x77, 0x9b, 0x5b, 0xcb, 0x7b, 0x65, 0xcf, 0x43, 0x44, 0x72, 0x17,
+        0x78, 0xdf, 0xe9, 0x84, 0xe6, 0x0b, 0xe7, 0xa7, 0x4f, 0xba, 0x5c, 0xf1, 0xaf, 0x6a, 0xd4, 0xe9,
+        0xb3, 0xeb, 0x1c, 0x8d, 0xed, 0x48, 0xce, 0xbe, 0x66, 0xbc, 0x78, 0xc0, 0x28, 0x34, 0x7a, 0x3f,
+        0xda, 0x02, 0x0c, 0x85, 0x6e, 0x15, 0x53, 0x8d, 0xdc, 0x82, 0x4b, 0x5b, 0xd6, 0xfe, 0x76, 0xc9,
+        0x2f, 0x9b, 0x45, 0x2e, 0x3a, 0x56, 0x25, 0xe5, 0x08, 0x56, 0x2c, 0x6b, 0xb0, 0xd9, 0x54, 0xc8,
+        0x01, 0x3c, 0xdd, 0x27, 0xfd, 0xed, 0xee, 0x03, 0x46, 0x2f, 0x0a, 0x36, 0x14, 0x88, 0xe6, 0x53,
+        0x99, 0xb3, 0x2c, 0x9b, 0x7f, 0xa8, 0x71, 0xad, 0x3c, 0x74, 0x8c, 0x58, 0xea, 0x91, 0xce, 0x00,
+        0x88, 0xe0, 0x52, 0x48, 0xc9, 0x13, 0x8c, 0x04, 0x2c, 0xc9, 0x44, 0xb1, 0x2d, 0x9d, 0xeb, 0xb9,
+        0xd3, 0x76, 0xca, 0x5d, 0x76, 0xd5, 0x28, 0xc4, 0xc6, 0x15, 0x96, 0x69, 0xb9, 0xbe, 0x14, 0x71,
+        0x5d, 0x3a, 0x72, 0x8d, 0xc4, 0x96, 0x36, 0xc5, 0x44, 0x43, 0x19, 0x23, 0x69, 0x30, 0x44, 0x45,
+        0x11, 0x7c, 0x4c, 0x39, 0x54, 0xc8, 0x1d, 0xf2, 0xba, 0x44, 0x58, 0x44, 0x8c, 0x71, 0x21, 0x81,
+        0x98, 0xc5, 0x29, 0x4f, 0xc6, 0xb0, 0x4e, 0x19, 0x7a, 0x57, 0x01, 0xed, 0x2a, 0xf1, 0x36, 0xa2,
+        0xd5, 0xb0, 0xac, 0xcb, 0x1c, 0x22, 0x56, 0x89, 0x88, 0x16, 0xee, 0xad, 0x58, 0x4d, 0x68, 0x6b,
+        0x76, 0x4b, 0x98, 0xc1, 0xdb, 0xa3, 0xbd, 0x65, 0x53, 0xe8, 0x50, 0x02, 0x2f, 0x7d, 0x91, 0x04,
+        0xf0, 0x2f, 0xd4, 0x5c, 0x35, 0x75, 0x01, 0x49, 0x19, 0x37, 0x39, 0x26, 0x88, 0xf0, 0x81, 0xab,
+        0xb3, 0x8c, 0x53, 0xf3, 0xd7, 0xcd, 0x79, 0x42, 0x42, 0x47, 0xf0, 0x6d, 0x8f, 0xec, 0xb9, 0xe5,
+        0x45, 0x22, 0xc1, 0x44, 0x32, 0x49, 0x41, 0x09, 0xe9, 0x09, 0x99, 0x78, 0x48, 0x91, 0x9e, 0x4c,
+        0x52, 0x6f, 0x03, 0xac, 0xe6, 0xa8, 0x31, 0xe1, 0x63, 0x30, 0xd8, 0xa3, 0xe1, 0x18, 0x37, 0x41,
+        0xb2, 0x15, 0xd7, 0x12, 0xb9, 0xb6, 0x69, 0x4d, 0xc6, 0x14, 0x7c, 0x0d, 0x7f, 0xf2, 0xc5, 0x6d,
+        0x19, 0x7f, 0xe1, 0xca, 0xf7, 0xd6, 0xf2, 0x30, 0x8a, 0x3c, 0xf8, 0x09, 0xb2, 0x32, 0x66, 0x64,
+        0x61, 0x98, 0x62, 0x02, 0x20, 0xd7, 0xe2, 0x98, 0x77, 0x78, 0x30, 0x89, 0xbc, 0xc0, 0x31, 0x3f,
+        0x13, 0x2b, 0xee, 0xe7, 0x74, 0x00, 0xb1, 0x04, 0x7f, 0x2d, 0xc3, 0x1a, 0x7d, 0xb0, 0x21, 0xf6,
+        0x70, 0x98, 0xcd, 0x60, 0x12, 0xa0, 0x92, 0x50, 0xa2, 0xc5, 0x3e, 0xe9, 0xf9, 0x24, 0x0a, 0x75,
+        0x70, 0x5c, 0xd7, 0x6c, 0x83, 0x6b, 0xcc, 0x81, 0xba, 0x9d, 0x96, 0x68, 0xe0, 0x55, 0x45, 0x4d,
+        0xe9, 0x9b, 0xcb, 0x30, 0x06, 0x4d, 0x70, 0x39, 0x36, 0x7c, 0xc2, 0xaf, 0x19, 0xe7, 0x04, 0x18,
+        0x32, 0xd2, 0xf4, 0x42, 0x51, 0x14, 0xbc, 0xfe, 0xfd, 0xe3, 0xe5, 0x05, 0x1e, 0xc6, 0xf3, 0x8e,
+        0x70, 0xc2, 0x2c, 0x0b, 0x91, 0x64, 0x67, 0xe8, 0x24, 0xbf, 0x53, 0xe1, 0xeb, 0x09, 0xcc, 0xb3,
+        0x66, 0x3d, 0x00, 0x81, 0x50, 0x6a, 0x9d, 0x16, 0x08, 0x63, 0x40, 0x2b, 0x67, 0xd4, 0xc2, 0x2f,
+        0xb6, 0x71, 0x27, 0xee, 0xe1, 0x10, 0x17, 0x1f, 0xe9, 0xb5, 0x66, 0x5d, 0xd8, 0x9a, 0x84, 0x1b,
+        0xf8, 0x76, 0x48, 0x4b, 0xd3, 0xe9, 0x3b, 0x73, 0xcd, 0x0a, 0x6b, 0x2f, 0xe6, 0x00, 0x2b, 0xa9,
+        0xc7, 0xbf, 0xe1, 0x6f, 0x17, 0x07, 0x1d, 0xce, 0x3e, 0x6b, 0x85, 0xbe, 0xb1, 0xd3, 0x52, 0x43,
+        0xe3, 0x16, 0x56, 0x75, 0xa9, 0x4a, 0xba, 0x77, 0x61, 0xce, 0xaa, 0x10, 0x0b, 0x85, 0xcc, 0xef,
+        0x38, 0xf3, 0x4f, 0xc3, 0xeb, 0xcd, 0xad, 0xd6, 0x52, 0xd6, 0xc7, 0x38, 0xe3, 0xbd, 0x30, 0x89,
+        0x04, 0x74, 0x7c, 0xf0, 0x82, 0x31, 0xf4, 0x58, 0x70, 0x87, 0x75, 0xdc, 0xd8, 0x7c, 0xf4, 0xc8,
+        0x18, 0x22, 0xb5, 0xa1, 0xad, 0x6f, 0x76, 0x32, 0x16, 0x11, 0x6e, 0x92, 0xc7, 0x16, 0xb8, 0x97,
+        0xbe, 0x67, 0x26, 0x3d, 0x7d, 0x20, 0x3b, 0x31, 0xe0, 0x17, 0x23, 0x35, 0xe0, 0x17, 0x3d, 0xb1,
+        0xe3, 0x97, 0x0a, 0x97, 0x75, 0x27, 0x8b, 0x91, 0x56, 0x8a, 0xdb, 0x0b, 0xe1, 0x7b, 0x98, 0x14,
+        0x3d, 0x0b, 0x6a, 0xb5, 0xad, 0x87, 0x42, 0x8a, 0x1b, 0x39, 0x35, 0x18, 0xfa, 0x04, 0xc4, 0x69,
+        0x41, 0x1c, 0x6e, 0xd3, 0xcc, 0x8b, 0x6e, 0xa4, 0x0b, 0xa5, 0x9e, 0xde, 0x12, 0x68, 0x6c, 0x2b,
+        0xa4, 0x6a, 0xfb, 0x6c, 0x4c, 0x1d, 0xda, 0xb1, 0x8d, 0xae, 0x83, 0x73, 0x36, 0x18, 0xd2, 0x88,
+        0xa9, 0x23, 0xb4, 0x0d, 0x8e, 0xaa, 0xe1, 0x5a, 0x82, 0xe4, 0x7d, 0x41, 0x34, 0xda, 0x47, 0x06,
+        0x7a, 0x90, 0x08, 0xc9, 0x16, 0x98, 0xb2, 0x3d, 0xe4, 0xa0, 0xe7, 0x05, 0xb4, 0x70, 0x7e, 0xc3,
+        0xf3, 0x72, 0xd5, 0x07, 0x56, 0x0a, 0x5d, 0x26, 0xab, 0x79, 0x2d, 0x38, 0x5b, 0x94, 0xf0, 0x3d,
+        0xcb, 0x03, 0xe2, 0xe0, 0xd9, 0x0a, 0xa1, 0xbc, 0x10, 0x58, 0xfc, 0x20, 0x7c, 0xed, 0x8c, 0x4b,
+        0x90, 0xd6, 0x19, 0xc6, 0x1d, 0x31, 0xa2, 0x5b, 0x51, 0x89, 0x7b, 0x8e, 0x0e, 0xa0, 0x24, 0x68,
+        0x28, 0x13, 0x62, 0xf0, 0xa7, 0x04, 0x5b, 0x3c, 0xf8, 0x13, 0xa4, 0xd7, 0xe4, 0xbd, 0x75, 0x0b,
+        0x98, 0xc8, 0x70, 0x37, 0x41, 0xaf, 0x8e, 0x71, 0xf1, 0x7c, 0x8e, 0x73, 0x63, 0xf4, 0x34, 0xb5,
+        0x0e, 0x02, 0xf8, 0x11, 0xde, 0xbc, 0x7b, 0x47, 0x13, 0xba, 0x71, 0x6f, 0x57, 0x7d, 0x0b, 0x9e,
+        0xb0, 0xdb, 0x1c, 0x70, 0xd0, 0xf0, 0x38, 0x13, 0xf1, 0x97, 0x67, 0x0c, 0xb7, 0x97, 0x78, 0xb6,
+        0x7d, 0xb1, 0x8e, 0x3a, 0x09, 0xea, 0x87, 0xb2, 0xc2, 0x5d, 0xb8, 0x8f, 0xa6, 0x4e, 0xba, 0x29,
+        0x87, 0xfb, 0x46, 0x6a, 0xc7, 0xc8, 0x96, 0xe7, 0xac, 0xaa, 0x30, 0xbe, 0x9d, 0xa4, 0x22, 0x4b,
+        0xfc, 0xaa, 0xbb, 0xd2, 0x40, 0xd7, 0x02, 0xad, 0x45, 0x9b, 0x5b, 0xcf, 0x51, 0x88, 0xb0, 0x57,
+        0xc0, 0x24, 0x5e, 0x98, 0xcf, 0xfa, 0xbc, 0xe0, 0xac, 0xb1, 0xc5, 0x0a, 0x2e, 0xa5, 0x5c, 0x7e,
+        0x62, 0x9e, 0x0c, 0xcf, 0xaf, 0x26, 0x8a, 0xbc, 0x82, 0x4b, 0xf6, 0xd5, 0x5e, 0x32, 0xbc, 0xd9,
+        0x3a, 0x3f, 0x85, 0x96, 0x2e, 0xfa, 0x5a, 0x77, 0x16, 0x7d, 0x3f, 0x8a, 0xbb, 0x01, 0xa0, 0xc5,
+        0x2f, 0xc4, 0x87, 0x0c, 0xe6, 0x07, 0xff, 0xce, 0x7b, 0xb1, 0xaf, 0xff, 0x79, 0xf7, 0x01, 0x29,
+        0xc1, 0xff, 0x14, 0x0e, 0xfa, 0x32, 0xfb, 0x7f, 0x91, 0x8d, 0xfc, 0x45, 0x30, 0x5d, 0x32, 0x95,
+        0x86, 0x35, 0xd6, 0xa6, 0x88, 0x28, 0x71, 0xee, 0x43, 0x56, 0x32, 0x97, 0x75, 0x01, 0xbc, 0x82,
+        0x09, 0x2a, 0xd5, 0x98, 0x51, 0xe2, 0x49, 0x08, 0x8c, 0xfd, 0xc0, 0x92, 0xee, 0xcd, 0x18, 0x77,
+        0xb1, 0x0c, 0xa3, 0x29, 0x97, 0x71, 0xa6, 0x8f, 0x3c, 0xdd, 0x1a, 0x98, 0xc3, 0x9b, 0x9f, 0x83,
+        0x9e, 0x8b, 0xf6, 0x18, 0xa6, 0xda, 0x1f, 0xc6, 0x4b, 0x9f, 0x70, 0xf7, 0x08, 0x56, 0xff, 0xdb,
+        0xf1, 0xd0, 0x55, 0x09, 0xee, 0x03, 0x13, 0x60, 0x75, 0xee, 0x15, 0x05, 0x0e, 0x8a, 0xc4, 0xe6,
+        0x9d, 0x4f, 0x37, 0x17, 0xb7, 0x9c, 0xd5, 0x71, 0x7a, 0xcd, 0xb0, 0xee, 0x91, 0x7e, 0x97, 0x7c,
+        0xa5, 0x1e, 0x0d, 0xa8, 0x1c, 0x20, 0xd8, 0xf4, 0x1a, 0xf2, 0x26, 0x1d, 0xda, 0x76, 0x03, 0x62,
+        0x4d, 0xfe, 0x04, 0x65, 0x90, 0x14, 0x7f, 0x60, 0xfd, 0x8a, 0xf7, 0x13, 0xd6, 0xac, 0xad, 0x1a,
+        0xb0, 0x6a, 0xd1, 0xf1, 0xc9, 0x9a, 0x40, 0x21, 0x88, 0x26, 0xf1, 0xb1, 0x03, 0x7a, 0x24, 0xc4,
+        0xf0, 0xb1, 0xb7, 0xe4, 0x0a, 0x63, 0xb4, 0xd7, 0x55, 0x31, 0xb4, 0x75, 0xca, 0x0b, 0x27, 0x6a,
+        0xd7, 0x4e, 0x06, 0xa9, 0xc3, 0xbf, 0x25, 0x26, 0x4e, 0x7d, 0xc2, 0x5d, 0x39, 0x9b, 0x34, 0xdc,
+        0x0a, 0x48, 0x86, 0x5d, 0xcf, 0xd2, 0xde, 0x3e, 0x55, 0x1f, 0x1d, 0x00, 0xc1, 0x33, 0x33, 0x56,
+        0xae, 0xad, 0xb6, 0x07, 0x04, 0xdb, 0x29, 0x92, 0x74, 0xab, 0x09, 0xc7, 0x93, 0x58, 0x42, 0x84,
+        0xa6, 0x8d, 0xd5, 0x44, 0xd1, 0x64, 0x59, 0x3f, 0xd0, 0xde, 0xbf, 0x6d, 0xee, 0xda, 0x5c, 0xae,
+        0x77, 0xc7, 0x11, 0x53, 0x36, 0x62, 0x55, 0x49, 0xec, 0x3b, 0xda, 0xbe, 0x1f, 0x32, 0x8c, 0xb7,
+        0x2e, 0x72, 0xfb, 0xbc, 0xda, 0xda, 0xa5, 0x1d, 0x7c, 0x2c, 0x83, 0x80, 0xb4, 0xc0, 0x5c, 0xf0,
+        0x44, 0x0e, 0x1c, 0xc2, 0x3e, 0xa8, 0xcc, 0x29, 0x6c, 0x87, 0xe4, 0x2b, 0x07, 0xeb, 0xca, 0xf1,
+        0x89, 0xf7, 0xdb, 0xf5, 0xf9, 0x15, 0x39, 0xba, 0x22, 0xaf, 0xb8, 0x8b, 0x9c, 0x76, 0x30, 0xa0,
+        0xa8, 0x7f, 0x51, 0x19, 0x5d, 0x7d, 0xdf, 0x41, 0xad, 0x1f, 0x1c, 0xda, 0xa2, 0x7d, 0xda, 0xd0,
+        0x06, 0x77, 0xde, 0xd5, 0x72, 0x89, 0x57, 0xc5, 0x33, 0x2f, 0x0f, 0x6a, 0x7d, 0x28, 0xb3, 0xac,
+        0x5c, 0x63, 0xfb, 0xbe, 0xdf, 0xb0, 0x5d, 0xd2, 0xe2, 0xd7, 0xbf, 0x55, 0xb6, 0x10, 0xec, 0x87,
+        0x1d, 0x39, 0xf3, 0x5c, 0x19, 0xe0, 0x44, 0x3f, 0xd9, 0x4a, 0x3b, 0xaf, 0xc1, 0xc7, 0x01, 0x96,
+        0xea, 0x57, 0xac, 0xf1, 0x6b, 0x45, 0x17, 0x46, 0x87, 0xd4, 0x9b, 0xbe, 0x4f, 0xef, 0xff, 0xaa,
+        0xca, 0x36, 0xba, 0xe0, 0xd6, 0xfb, 0xe8, 0x87, 0x00, 0xa9, 0xc0, 0x64, 0xa0, 0x48, 0x46, 0xf6,
+        0xf1, 0x56, 0x6b, 0x33, 0xaf, 0x98, 0x01, 0xbb, 0xcc, 0x84, 0x95, 0xda, 0x79, 0xbd, 0x0c, 0x88,
+        0xef, 0x48, 0xb4, 0x67, 0xe9, 0x1e, 0x32, 0x43, 0x27, 0xef, 0x26, 0x4d, 0x3c, 0xc3, 0xf7, 0x8d,
+        0x7d, 0xd3, 0x60, 0xbd, 0x60, 0xfe, 0x6a, 0x14, 0x99, 0xbf, 0x63, 0xfd, 0x07, 0xd5, 0x59, 0x15,
+        0x8c, 0xdf, 0x12, 0x00, 0x00
+    };
+#endif
@@ -0,0 +1,166 @@
+/*
+  DdpReceiver - Receives pixel data sent with the Distributed Display Protocol,
+  which show control software such as xLights uses to drive strips in real
+  time. The pixel data of each packet is read from the UDP buffer straight
+  into the frame at the offset the packet gives, so a frame may be spread
+  over any number of packets which can arrive in any order. A frame is ready
+  to show once a packet with the push flag arrives.
+*/
+
+#include <DdpReceiver.h>
+
+DdpReceiver::DdpReceiver() {
+    lastSequence = 0u;
+    packetCount = 0ul;
+    frameCount = 0ul;
+    lostPackets = 0ul;
+    outOfOrderPackets = 0ul;
+    malformedPackets = 0ul;
+}
+
+/**
+ * Starts listening for packets.
+ * 
+ * @param port - The UDP port to listen on, normally DDP_PORT.
+ * 
+ * @return Returns true if listening otherwise false as bool.
+*/
+bool DdpReceiver::begin(uint16_t port) {
+    return udp.begin(port) == 1u;
+}
+
+/**
+ * Checks for a packet waiting to be read, any packet left unread
+ * from before is discarded.
+ * 
+ * @return Returns true if there is a packet to read otherwise false as bool.
+*/
+bool DdpReceiver::available() {
+    return udp.parsePacket() > 0;
+}
+
+/**
+ * Reads the waiting packet, copying its pixel data into the given frame.
+ * Data beyond the end of the frame is dropped.
+ * 
+ * @param pixels - The frame as RGB byte triples.
+ * @param size - The size of the frame in bytes.
+ * 
+ * @return Returns what the packet held as DdpResult.
+*/
+DdpResult DdpReceiver::read(uint8_t *pixels, size_t size) {
+    uint8_t data[DDP_HEADER_SIZE + DDP_TIMECODE_SIZE];
+    size_t length = udp.available();
+    size_t headerLength = udp.read(data, length < sizeof(data) ? length : sizeof(data));
+
+    DdpHeader header;
+    if (!parseHeader(data, headerLength, header) || header.headerSize + header.length > length) {
+        malformedPackets++;
+
+        return DDP_IGNORED;
+    }
+    packetCount++;
+    if ((header.flags & DDP_FLAG_QUERY) || (header.destination != DDP_ID_DISPLAY && header.destination != DDP_ID_ALL)) {
+        return DDP_IGNORED;
+    }
+    if (header.dataType != 0x00u && header.dataType != 0x01u && header.dataType != 0x0Bu) { // Only 8 bit RGB is understood
+        return DDP_IGNORED;
+    }
+    trackSequence(header.sequence);
+
+    // The rest of the header was read with the data, put it where it belongs
+    size_t read = headerLength - header.headerSize;
+    if (header.offset < size) {
+        size_t room = size - header.offset;
+        size_t wanted = (header.length < room ? header.length : room);
+        if (read > wanted) {
+            read = wanted;
+        }
+        memcpy(&pixels[header.offset], &data[header.headerSize], read);
+        if (wanted > read) {
+            udp.read(&pixels[header.offset + read], wanted - read);
+        }
+    }
+
+    if (header.flags & DDP_FLAG_PUSH) {
+        frameCount++;
+
+        return DDP_PUSH;
+    }
+
+    return DDP_DATA;
+}
+
+/**
+ * Reads a DDP header.
+ * 
+ * @param data - The start of the packet.
+ * @param length - The bytes of the packet available.
+ * @param header - Where to put the header.
+ * 
+ * @return Returns true if the data starts with a version 1 header
+ * otherwise false as bool.
+*/
+bool DdpReceiver::parseHeader(const uint8_t *data, size_t length, DdpHeader &header) {
+    if (length < DDP_HEADER_SIZE || (data[0] & DDP_FLAG_VERSION_MASK) != DDP_FLAG_VERSION_1) {
+        return false;
+    }
+
+    header.flags = data[0];
+    header.sequence = data[1] & 0x0Fu;
+    header.dataType = data[2];
+    header.destination = data[3];
+    header.offset = ((uint32_t) data[4] << 24) | ((uint32_t) data[5] << 16) | ((uint32_t) data[6] << 8) | data[7];
+    header.length = ((uint16_t) data[8] << 8) | data[9];
+    header.headerSize = DDP_HEADER_SIZE;
+    if (header.flags & DDP_FLAG_TIMECODE) {
+        if (length < DDP_HEADER_SIZE + DDP_TIMECODE_SIZE) {
+            return false;
+        }
+        header.headerSize += DDP_TIMECODE_SIZE;
+    }
+
+    return true;
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Counts packets missing from, or out of order in, the sequence.
+ * Sequence numbers run from 1 to 15 and then wrap, a packet up to
+ * 7 ahead of the last one is taken as newer and the packets
+ * between as lost, anything else as having arrived out of order.
+ * A packet which arrives out of order is still used, it
+ * carries data for its own part of the frame.
+ * 
+ * @param sequence - The sequence number of the packet.
+*/
+void DdpReceiver::trackSequence(uint8_t sequence) {
+    if (sequence == 0u) {
+        return;
+    }
+    if (lastSequence != 0u) {
+        uint8_t ahead = (sequence + 15u - lastSequence) % 15u; // Distance in the 1..15 cycle
+        if (ahead == 0u || ahead > 7u) {
+            outOfOrderPackets++;
+            if (lostPackets > 0ul) {
+                lostPackets--; // It was counted as lost when a later one arrived
+            }
+
+            return;
+        }
+        lostPackets += ahead - 1u;
+    }
+    lastSequence = sequence;
+}
+
+unsigned long DdpReceiver::getPacketCount() { return packetCount; }
+unsigned long DdpReceiver::getFrameCount() { return frameCount; }
+unsigned long DdpReceiver::getLostPackets() { return lostPackets; }
+unsigned long DdpReceiver::getOutOfOrderPackets() { return outOfOrderPackets; }
+unsigned long DdpReceiver::getMalformedPackets() { return malformedPackets; }
@@ -0,0 +1,77 @@
+/*
+  DdpReceiver - Receives pixel data sent with the Distributed Display Protocol,
+  which show control software such as xLights uses to drive strips in real
+  time. The pixel data of each packet is read from the UDP buffer straight
+  into the frame at the offset the packet gives, so a frame may be spread
+  over any number of packets which can arrive in any order. A frame is ready
+  to show once a packet with the push flag arrives.
+*/
+
+#ifndef DdpReceiver_h
+    #define DdpReceiver_h
+
+    #include <Arduino.h>
+    #include <WiFiUdp.h>
+
+    #define DDP_PORT 4048u
+    #define DDP_HEADER_SIZE 10u
+    #define DDP_TIMECODE_SIZE 4u
+
+    #define DDP_FLAG_VERSION_MASK 0xC0u
+    #define DDP_FLAG_VERSION_1 0x40u
+    #define DDP_FLAG_TIMECODE 0x10u
+    #define DDP_FLAG_QUERY 0x02u
+    #define DDP_FLAG_PUSH 0x01u
+
+    #define DDP_ID_DISPLAY 1u
+    #define DDP_ID_ALL 255u
+
+    /**
+     * The fields of a DDP header which matter to a receiver.
+     */
+    struct DdpHeader {
+        uint8_t      flags               ;
+        uint8_t      sequence            ; // 1 to 15, or 0 when the sender doesn't number packets
+        uint8_t      dataType            ;
+        uint8_t      destination         ;
+        uint32_t     offset              ; // In bytes
+        uint16_t     length              ; // Bytes of data which follow the header
+        uint8_t      headerSize          ;
+    };
+
+    enum DdpResult : uint8_t {
+        DDP_NONE,    // Nothing was received
+        DDP_IGNORED, // A packet which holds no pixel data for this device
+        DDP_DATA,    // Pixel data for a frame still being received
+        DDP_PUSH     // Pixel data which completes a frame
+    };
+
+    class DdpReceiver {
+        private:
+            WiFiUDP          udp                     ;
+            uint8_t          lastSequence            ;
+            unsigned long    packetCount             ;
+            unsigned long    frameCount              ;
+            unsigned long    lostPackets             ; // Missing from the sequence
+            unsigned long    outOfOrderPackets       ; // Arrived after a later one
+            unsigned long    malformedPackets        ;
+
+            void trackSequence(uint8_t sequence);
+
+        public:
+            DdpReceiver();
+
+            bool begin(uint16_t port);
+            bool available();
+            DdpResult read(uint8_t *pixels, size_t size);
+
+            static bool parseHeader(const uint8_t *data, size_t length, DdpHeader &header);
+
+            // Getters defined below
+            unsigned long    getPacketCount          ();
+            unsigned long    getFrameCount           ();
+            unsigned long    getLostPackets          ();
+            unsigned long    getOutOfOrderPackets    ();
+            unsigned long    getMalformedPackets     ();
+    };
+#endif
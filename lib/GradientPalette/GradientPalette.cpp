@@ -0,0 +1,272 @@
+/*
+  GradientPalette - A palette of up to 256 colors which is spread out into a
+  smooth gradient for effects to draw from. The colors are kept in LittleFS
+  packed as three bytes each and are only read once the gradient is needed,
+  at which point the gradient is worked out once and kept. Reading and writing
+  the colors goes through a small chunk buffer, so nothing is held in RAM
+  until the gradient is needed, and the colors themselves never are.
+*/
+
+#include <GradientPalette.h>
+
+GradientPalette::GradientPalette() {
+    gradient = nullptr;
+    count = 0u;
+    stale = true;
+    chunkLength = 0u;
+    chunkPosition = 0u;
+}
+
+/**
+ * Works out the gradient from the stored palette when it has yet to be
+ * or the palette has been saved since. This reads from flash, so it is
+ * meant to be called between frames rather than while rendering. The
+ * gradient isn't worked out for the first time until it is in use.
+ * 
+ * @param inUse - Whether an effect is drawing from the gradient.
+ * 
+ * @return Returns true if the gradient changed, and should be handed
+ * to the effects again, otherwise false as bool.
+*/
+bool GradientPalette::service(bool inUse) {
+    if (!stale || (!inUse && gradient == nullptr)) {
+        return false;
+    }
+    load();
+
+    return true;
+}
+
+/**
+ * Gives the gradient as it was last worked out by service(). The
+ * gradient runs through the colors in order and blends from the
+ * last back into the first, so it can be scrolled around.
+ * 
+ * @return Returns GRADIENT_SIZE colors of three bytes of RGB each, or
+ * nullptr if there is no palette, as const uint8*.
+*/
+const uint8 *GradientPalette::getGradient() {
+    return (count > 0u ? gradient : nullptr);
+}
+
+/**
+ * Opens the stored palette for its colors to be read with readColors().
+ * The whole palette is checked against its CRC first, a chunk at a time.
+ * closeColors() must be called once done.
+ * 
+ * @return Returns the number of colors, 0 if there is no valid
+ * palette, as unsigned int.
+*/
+unsigned int GradientPalette::openColors() {
+    chunkLength = 0u;
+    chunkPosition = 0u;
+    file = LittleFS.open(GRADIENT_PALETTE_FILE, "r");
+    if (!file) {
+        return 0u;
+    }
+
+    PaletteHeader header;
+    bool ok = file.read((uint8 *) &header, sizeof(header)) == sizeof(header)
+        && header.magic == GRADIENT_PALETTE_MAGIC && header.version == GRADIENT_PALETTE_VERSION
+        && header.reserved == 0u && header.count > 0u && header.count <= GRADIENT_PALETTE_MAX_COLORS;
+    uint32 crc = 0ul;
+    for (unsigned int read = 0u; ok && read < header.count; ) {
+        unsigned int colors = (header.count - read < GRADIENT_PALETTE_CHUNK_COLORS ? header.count - read : GRADIENT_PALETTE_CHUNK_COLORS);
+        ok = file.read(chunk, colors * 3u) == colors * 3u;
+        crc = Utils::crc32(chunk, colors * 3u, crc);
+        read += colors;
+    }
+    ok = ok && crc == header.crc && file.seek(sizeof(header));
+    if (!ok) {
+        file.close();
+
+        return 0u;
+    }
+
+    return header.count;
+}
+
+/**
+ * Reads the next colors of the palette opened by openColors().
+ * 
+ * @param colors - Where to put the colors, three bytes of RGB each.
+ * @param maxCount - The number of colors there is room for.
+ * 
+ * @return Returns the number of colors read, 0 once there are no
+ * more, as unsigned int.
+*/
+unsigned int GradientPalette::readColors(uint8 *colors, unsigned int maxCount) {
+    if (!file) {
+        return 0u;
+    }
+
+    return file.read(colors, maxCount * 3u) / 3u;
+}
+
+void GradientPalette::closeColors() {
+    if (file) {
+        file.close();
+    }
+}
+
+/**
+ * Starts replacing the stored palette, its colors follow through
+ * saveColor() and endSave() finishes it. Saving a palette of no
+ * colors removes it.
+ * 
+ * @param count - The number of colors which will follow.
+ * @param crc - The CRC32 of the colors which will follow.
+ * 
+ * @return Returns true if the palette could be started otherwise
+ * false as bool.
+*/
+bool GradientPalette::beginSave(unsigned int count, uint32 crc) {
+    if (count > GRADIENT_PALETTE_MAX_COLORS) {
+        return false;
+    }
+    chunkLength = 0u;
+    stale = true;
+    if (count == 0u) {
+        return !LittleFS.exists(GRADIENT_PALETTE_FILE) || LittleFS.remove(GRADIENT_PALETTE_FILE);
+    }
+
+    PaletteHeader header = {
+        GRADIENT_PALETTE_MAGIC,
+        GRADIENT_PALETTE_VERSION,
+        0u,
+        (uint16) count,
+        crc
+    };
+    file = LittleFS.open(GRADIENT_PALETTE_FILE, "w");
+    if (!file) {
+        return false;
+    }
+    if (file.write((const uint8 *) &header, sizeof(header)) != sizeof(header)) {
+        file.close();
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Adds the next color of the palette being saved.
+ * 
+ * @param rgb - The color as three bytes of RGB.
+ * 
+ * @return Returns true if it was taken otherwise false as bool.
+*/
+bool GradientPalette::saveColor(const uint8 *rgb) {
+    if (!file) {
+        return false;
+    }
+    memcpy(&chunk[chunkLength * 3u], rgb, 3u);
+    chunkLength++;
+
+    return chunkLength < GRADIENT_PALETTE_CHUNK_COLORS || flushChunk();
+}
+
+/**
+ * Finishes saving the palette, service() then works out its
+ * gradient again.
+ * 
+ * @return Returns true if the whole palette was written otherwise
+ * false as bool.
+*/
+bool GradientPalette::endSave() {
+    if (!file) {
+        return true; // Nothing to write, the palette was removed
+    }
+    bool ok = flushChunk();
+    file.close();
+
+    return ok;
+}
+
+unsigned int GradientPalette::getCount() { return count; }
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Reads the stored palette and spreads its colors out evenly over
+ * the gradient, blending between each and the next. The colors are
+ * streamed through the chunk buffer, only the two being blended
+ * between and the first, which the last blends into, are held.
+*/
+void GradientPalette::load() {
+    stale = false;
+    count = openColors();
+    if (count == 0u) {
+        return;
+    }
+    if (gradient == nullptr) {
+        gradient = new uint8[GRADIENT_SIZE * 3u];
+    }
+
+    uint8 first[3], from[3], to[3];
+    bool ok = nextColor(first);
+    memcpy(from, first, 3u);
+    memcpy(to, first, 3u);
+    ok = ok && (count == 1u || nextColor(to));
+    unsigned int toIndex = 1u;
+    for (unsigned int g = 0u; ok && g < GRADIENT_SIZE; g++) {
+        unsigned int position = g * count; // In 256ths of a color
+        while (ok && toIndex <= (position >> 8)) {
+            memcpy(from, to, 3u);
+            toIndex++;
+            if (toIndex < count) {
+                ok = nextColor(to);
+            } else {
+                memcpy(to, first, 3u);
+            }
+        }
+        int amount = position & 0xFFu;
+        for (unsigned int c = 0u; c < 3u; c++) {
+            gradient[(g * 3u) + c] = from[c] + (((to[c] - from[c]) * amount) >> 8);
+        }
+    }
+    closeColors();
+    if (!ok) {
+        count = 0u;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Reads the next color of the open palette through the chunk buffer.
+ * 
+ * @param rgb - Where to put the color as three bytes of RGB.
+ * 
+ * @return Returns true if there was a color otherwise false as bool.
+*/
+bool GradientPalette::nextColor(uint8 *rgb) {
+    if (chunkPosition == chunkLength) {
+        chunkLength = readColors(chunk, GRADIENT_PALETTE_CHUNK_COLORS);
+        chunkPosition = 0u;
+        if (chunkLength == 0u) {
+            return false;
+        }
+    }
+    memcpy(rgb, &chunk[chunkPosition * 3u], 3u);
+    chunkPosition++;
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Writes the colors waiting in the chunk buffer to the palette
+ * being saved.
+*/
+bool GradientPalette::flushChunk() {
+    size_t size = chunkLength * 3u;
+    chunkLength = 0u;
+
+    return file.write(chunk, size) == size;
+}
@@ -0,0 +1,63 @@
+/*
+  GradientPalette - A palette of up to 256 colors which is spread out into a
+  smooth gradient for effects to draw from. The colors are kept in LittleFS
+  packed as three bytes each and are only read once the gradient is needed,
+  at which point the gradient is worked out once and kept. Reading and writing
+  the colors goes through a small chunk buffer, so nothing is held in RAM
+  until the gradient is needed, and the colors themselves never are.
+*/
+
+#ifndef GradientPalette_h
+    #define GradientPalette_h
+
+    #include <Arduino.h>
+    #include <LittleFS.h>
+    #include <Utils.h>
+
+    #define GRADIENT_PALETTE_FILE "/palette.bin"
+    #define GRADIENT_PALETTE_MAGIC 0x41504253ul // "SBPA"
+    #define GRADIENT_PALETTE_VERSION 1u
+    #define GRADIENT_PALETTE_MAX_COLORS 256u
+    #define GRADIENT_PALETTE_CHUNK_COLORS 16u // Colors read or written at a time
+    #define GRADIENT_SIZE 256u
+
+    class GradientPalette {
+        private:
+            struct PaletteHeader {
+                uint32           magic                   ;
+                uint8            version                 ;
+                uint8            reserved                ; // Always 0
+                uint16           count                   ;
+                uint32           crc                     ; // CRC32 of the colors
+            };
+
+            uint8            *gradient                                       ; // GRADIENT_SIZE colors of RGB, nullptr until first needed
+            unsigned int     count                                           ;
+            bool             stale                                           ; // The stored palette has changed since the gradient was worked out
+            File             file                                            ; // Open while reading or saving
+            uint8            chunk       [GRADIENT_PALETTE_CHUNK_COLORS * 3u]  ;
+            unsigned int     chunkLength                                     ; // In colors
+            unsigned int     chunkPosition                                   ; // In colors
+
+            void load();
+            bool nextColor(uint8 *rgb);
+            bool flushChunk();
+
+        public:
+            GradientPalette();
+
+            bool service(bool inUse);
+            const uint8 *getGradient();
+
+            unsigned int openColors();
+            unsigned int readColors(uint8 *colors, unsigned int maxCount);
+            void closeColors();
+
+            bool beginSave(unsigned int count, uint32 crc);
+            bool saveColor(const uint8 *rgb);
+            bool endSave();
+
+            // Getters defined below
+            unsigned int        getCount        ();
+    };
+#endif
@@ -0,0 +1,252 @@
+/*
+  JsonReader - Reads small JSON documents of a known shape in place, without
+  building a tree or allocating. The caller walks the document in the order
+  it expects it, asking for each key and value in turn, and any value that
+  isn't what was asked for fails the read. Only what the device's API needs
+  is supported: objects, arrays, unsigned integers, booleans, null and
+  strings without escapes.
+*/
+
+#include <JsonReader.h>
+
+JsonReader::JsonReader(const char *json) {
+    this->json = json;
+    position = 0u;
+    failed = (json == nullptr);
+    first = true;
+}
+
+/**
+ * Reads the opening of an object.
+ * 
+ * @return Returns true if an object was opened otherwise false as bool.
+*/
+bool JsonReader::beginObject() {
+    first = true;
+
+    return expect('{');
+}
+
+/**
+ * Reads the key of the next member of the current object, leaving
+ * its value to be read next.
+ * 
+ * @param key - Where to write the key.
+ * @param size - The room for the key including its null.
+ * 
+ * @return Returns true if there was another member or false once the
+ * object is closed or the read has failed as bool.
+*/
+bool JsonReader::nextKey(char *key, size_t size) {
+    if (!nextMember('}')) {
+        return false;
+    }
+
+    return readString(key, size) && expect(':');
+}
+
+/**
+ * Reads the opening of an array.
+ * 
+ * @return Returns true if an array was opened otherwise false as bool.
+*/
+bool JsonReader::beginArray() {
+    first = true;
+
+    return expect('[');
+}
+
+/**
+ * Moves on to the next item of the current array, leaving it to be read next.
+ * 
+ * @return Returns true if there was another item or false once the
+ * array is closed or the read has failed as bool.
+*/
+bool JsonReader::nextItem() {
+    return nextMember(']');
+}
+
+/**
+ * Reads an unsigned integer value.
+ * 
+ * @param value - Where to put the value.
+ * 
+ * @return Returns true if an unsigned integer was read otherwise false as bool.
+*/
+bool JsonReader::readUnsigned(unsigned long &value) {
+    skipWhitespace();
+    if (failed || json[position] < '0' || json[position] > '9') {
+        failed = true;
+
+        return false;
+    }
+
+    unsigned long result = 0ul;
+    while (json[position] >= '0' && json[position] <= '9') {
+        unsigned long digit = json[position++] - '0';
+        if (result > (((unsigned long) -1) - digit) / 10ul) { // Too big
+            failed = true;
+
+            return false;
+        }
+        result = (result * 10ul) + digit;
+    }
+    value = result;
+
+    return true;
+}
+
+/**
+ * Reads a string value.
+ * 
+ * @param value - Where to write the string.
+ * @param size - The room for the string including its null, a longer
+ * string fails the read.
+ * 
+ * @return Returns true if a string was read otherwise false as bool.
+*/
+bool JsonReader::readString(char *value, size_t size) {
+    if (!expect('"')) {
+        return false;
+    }
+
+    size_t length = 0u;
+    while (json[position] != '"') {
+        if (json[position] == '\0' || json[position] == '\\' || length + 1u >= size) {
+            failed = true;
+
+            return false;
+        }
+        value[length++] = json[position++];
+    }
+    position++;
+    value[length] = '\0';
+
+    return true;
+}
+
+/**
+ * Reads a boolean value.
+ * 
+ * @param value - Where to put the value.
+ * 
+ * @return Returns true if true or false was read otherwise false as bool.
+*/
+bool JsonReader::readBool(bool &value) {
+    skipWhitespace();
+    if (!failed && strncmp(&json[position], "true", 4u) == 0) {
+        position += 4u;
+        value = true;
+
+        return true;
+    }
+    if (!failed && strncmp(&json[position], "false", 5u) == 0) {
+        position += 5u;
+        value = false;
+
+        return true;
+    }
+    failed = true;
+
+    return false;
+}
+
+/**
+ * Reads a null value.
+ * 
+ * @return Returns true if null was read otherwise false as bool.
+*/
+bool JsonReader::readNull() {
+    skipWhitespace();
+    if (failed || json[position] != 'n' || json[position + 1u] != 'u' || json[position + 2u] != 'l' || json[position + 3u] != 'l') {
+        failed = true;
+
+        return false;
+    }
+    position += 4u;
+
+    return true;
+}
+
+/**
+ * Checks that nothing but whitespace follows what has been read.
+ * 
+ * @return Returns true if the whole document was read without
+ * failing otherwise false as bool.
+*/
+bool JsonReader::end() {
+    skipWhitespace();
+
+    return !failed && json[position] == '\0';
+}
+
+bool JsonReader::hasFailed() {
+    return failed;
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Moves past any whitespace.
+*/
+void JsonReader::skipWhitespace() {
+    if (failed) {
+        return;
+    }
+    while (json[position] == ' ' || json[position] == '\t' || json[position] == '\r' || json[position] == '\n') {
+        position++;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Reads the given char, anything else fails the read.
+ * 
+ * @param c - The char expected.
+ * 
+ * @return Returns true if the char was read otherwise false as bool.
+*/
+bool JsonReader::expect(char c) {
+    skipWhitespace();
+    if (failed || json[position] != c) {
+        failed = true;
+
+        return false;
+    }
+    position++;
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Moves on to the next member of the current object or array,
+ * reading the comma between members or the closing char.
+ * 
+ * @param close - The char which closes the current object or array.
+ * 
+ * @return Returns true if there is another member otherwise false as bool.
+*/
+bool JsonReader::nextMember(char close) {
+    skipWhitespace();
+    if (failed) {
+        return false;
+    }
+    if (json[position] == close) {
+        position++;
+        first = false;
+
+        return false;
+    }
+    if (!first && !expect(',')) {
+        return false;
+    }
+    first = false;
+
+    return true;
+}
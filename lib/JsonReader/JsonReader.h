@@ -0,0 +1,43 @@
+/*
+  JsonReader - Reads small JSON documents of a known shape in place, without
+  building a tree or allocating. The caller walks the document in the order
+  it expects it, asking for each key and value in turn, and any value that
+  isn't what was asked for fails the read. Only what the device's API needs
+  is supported: objects, arrays, unsigned integers, booleans, null and
+  strings without escapes.
+*/
+
+#ifndef JsonReader_h
+    #define JsonReader_h
+
+    #include <stddef.h>
+    #include <string.h>
+
+    class JsonReader {
+        private:
+            const char      *json        ;
+            size_t          position     ;
+            bool            failed       ;
+            bool            first        ; // Nothing has been read yet from the current object or array
+
+            void skipWhitespace();
+            bool expect(char c);
+            bool nextMember(char close);
+
+        public:
+            JsonReader(const char *json);
+
+            bool beginObject();
+            bool nextKey(char *key, size_t size);
+            bool beginArray();
+            bool nextItem();
+
+            bool readUnsigned(unsigned long &value);
+            bool readString(char *value, size_t size);
+            bool readBool(bool &value);
+            bool readNull();
+            bool end();
+
+            bool hasFailed();
+    };
+#endif
@@ -0,0 +1,75 @@
+/*
+  Histogram - Collects durations into power of two buckets so that how long
+  something takes can be watched over time without keeping the samples. It
+  is a fixed size and recording a sample costs a few instructions, so it can
+  be left in place around the loop, rendering and the web handlers.
+*/
+
+#include <Histogram.h>
+
+Histogram::Histogram() {
+    reset();
+}
+
+/**
+ * Adds a sample to the histogram.
+ * 
+ * @param micros - The duration in micros.
+*/
+void Histogram::record(unsigned long micros) {
+    buckets[bucketOf(micros)]++;
+    count++;
+    totalMicros += micros;
+    if (micros > maxMicros) {
+        maxMicros = micros;
+    }
+}
+
+/**
+ * Forgets all the samples recorded so far.
+*/
+void Histogram::reset() {
+    for (unsigned int i = 0u; i < HISTOGRAM_BUCKETS; i++) {
+        buckets[i] = 0ul;
+    }
+    count = 0ul;
+    totalMicros = 0ull;
+    maxMicros = 0ul;
+}
+
+/**
+ * Works out which bucket the given duration is counted in.
+ * 
+ * @param micros - The duration in micros.
+ * 
+ * @return Returns the index of the bucket as unsigned int.
+*/
+unsigned int Histogram::bucketOf(unsigned long micros) {
+    if (micros == 0ul) {
+        return 0u;
+    }
+    unsigned int bucket = 32u - __builtin_clz((uint32_t) micros);
+
+    return (bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1u);
+}
+
+/**
+ * Gives the duration the given bucket counts up to, the last
+ * bucket has no limit so its lower bound is given instead.
+ * 
+ * @param bucket - The index of the bucket.
+ * 
+ * @return Returns the duration in micros as unsigned long.
+*/
+unsigned long Histogram::bucketLimit(unsigned int bucket) {
+    if (bucket >= HISTOGRAM_BUCKETS - 1u) {
+        return 1ul << (HISTOGRAM_BUCKETS - 2u);
+    }
+
+    return 1ul << bucket;
+}
+
+unsigned long Histogram::getBucket(unsigned int bucket) { return (bucket < HISTOGRAM_BUCKETS ? buckets[bucket] : 0ul); }
+unsigned long Histogram::getCount() { return count; }
+unsigned long Histogram::getMeanMicros() { return (count == 0ul ? 0ul : (unsigned long) (totalMicros / count)); }
+unsigned long Histogram::getMaxMicros() { return maxMicros; }
@@ -0,0 +1,38 @@
+/*
+  Histogram - Collects durations into power of two buckets so that how long
+  something takes can be watched over time without keeping the samples. It
+  is a fixed size and recording a sample costs a few instructions, so it can
+  be left in place around the loop, rendering and the web handlers.
+*/
+
+#ifndef Histogram_h
+    #define Histogram_h
+
+    #include <Arduino.h>
+
+    // Bucket 0 counts 0us, bucket n counts 2^(n-1) up to 2^n us, the last counts the rest
+    #define HISTOGRAM_BUCKETS 16u
+
+    class Histogram {
+        private:
+            unsigned long          buckets     [HISTOGRAM_BUCKETS]     ;
+            unsigned long          count                               ;
+            unsigned long long     totalMicros                         ;
+            unsigned long          maxMicros                           ;
+
+        public:
+            Histogram();
+
+            void record(unsigned long micros);
+            void reset();
+
+            static unsigned int bucketOf(unsigned long micros);
+            static unsigned long bucketLimit(unsigned int bucket);
+
+            // Getters defined below
+            unsigned long    getBucket           (unsigned int bucket);
+            unsigned long    getCount            ();
+            unsigned long    getMeanMicros       ();
+            unsigned long    getMaxMicros        ();
+    };
+#endif
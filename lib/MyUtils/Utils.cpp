@@ -17,6 +17,29 @@ String Utils::hashString(String string) {
     return builder.toString();
 }
 
+/**
+ * Calculates the standard CRC-32 (as used by zip and ethernet)
+ * of the given data. Data which comes in parts can be run through
+ * part by part, passing the CRC so far along each time.
+ * 
+ * @param data The data to calculate the CRC of.
+ * @param length The number of bytes of data.
+ * @param crc The CRC of the parts before this one, 0 for the first.
+ * 
+ * @return Returns the CRC as uint32.
+*/
+uint32 Utils::crc32(const uint8 *data, size_t length, uint32 crc) {
+    crc = ~crc;
+    while (length-- > 0u) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320ul & (0ul - (crc & 1ul)));
+        }
+    }
+
+    return ~crc;
+}
+
 /**
  * Generates a six character Device ID based on the
  * given macAddress.
@@ -36,60 +59,130 @@ String Utils::genDeviceIdFromMacAddr(String macAddress) {
     return result;
 }
 
-String Utils::decimalTo8BitHex(uint8 dec) {
-    String result = "";
-    uint8 d1 = dec >> 4;
-    uint8 d2 = dec & 0x0F;
+/**
+ * Writes the given value as two lowercase hex digits. No null
+ * terminator is written.
+ * 
+ * @param dec The value to convert as uint8.
+ * @param hex Where to write the two hex digits as char*.
+*/
+void Utils::decimalTo8BitHex(uint8 dec, char *hex) {
+    hex[0] = HEX_DIGITS[dec >> 4];
+    hex[1] = HEX_DIGITS[dec & 0x0F];
+}
 
-    result.concat(decToHexDigitMap[d1]);
-    result.concat(decToHexDigitMap[d2]);
+/**
+ * Reads the value of the two hex digits at the start of
+ * the given text, digits may be upper or lowercase.
+ * 
+ * @param hex The hex digits as const char*.
+ * @param dec Where to store the value as uint8.
+ * 
+ * @return Returns true if both digits were valid otherwise false as bool.
+*/
+bool Utils::hexTo8BitDecimal(const char *hex, uint8 &dec) {
+    uint8 high = hexDigitValue(hex[0]);
+    if (high == 0xFFu) {
+        return false;
+    }
+    uint8 low = hexDigitValue(hex[1]);
+    if (low == 0xFFu) {
+        return false;
+    }
+    dec = (high << 4) | low;
 
-    return result;
+    return true;
 }
 
-uint8 Utils::hexTo8BitDecimal(String hex) {
-    hex.toLowerCase();
-    uint8 result = 0u;
-    result = hexToDecDigitMap[hex.substring(0, 1)] << 4;
-    result = result | hexToDecDigitMap[hex.substring(1, 2)];
+/**
+ * Writes the given color as six hex digits followed by
+ * a null terminator.
+ * 
+ * @param hex Where to write the color, must have room for 7 chars.
+*/
+void Utils::rgbDecimalsToHex(uint8 red, uint8 green, uint8 blue, char *hex) {
+    decimalTo8BitHex(red, &hex[0]);
+    decimalTo8BitHex(green, &hex[2]);
+    decimalTo8BitHex(blue, &hex[4]);
+    hex[6] = '\0';
+}
 
-    return result;
+/**
+ * Reads a color given as six hex digits, RRGGBB, into a 
+ * single value of the form 0xRRGGBB.
+ * 
+ * @param hex The color as const char*.
+ * @param rgb Where to store the color as uint32.
+ * 
+ * @return Returns true if all six digits were valid otherwise false as bool.
+*/
+bool Utils::rgbHexToDecimal(const char *hex, uint32 &rgb) {
+    uint8 red, green, blue;
+    if (!hexTo8BitDecimal(&hex[0], red) || !hexTo8BitDecimal(&hex[2], green) || !hexTo8BitDecimal(&hex[4], blue)) {
+        return false;
+    }
+    rgb = ((uint32) red << 16) | ((uint32) green << 8) | blue;
+
+    return true;
 }
 
-String Utils::rgbDecimalsToHex(uint8 red, uint8 green, uint8 blue) {
-    String result = "";
-    result.concat(decimalTo8BitHex(red));
-    result.concat(decimalTo8BitHex(green));
-    result.concat(decimalTo8BitHex(blue));
+void Utils::rgbDecimalToHex(uint32 rgb, char *hex) {
+    rgbDecimalsToHex((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF, hex);
+}
 
-    return result;
+/**
+ * Reads a list of colors such as "RRGGBB:RRGGBB:RRGGBB" in a single pass.
+ * Reading stops at the end of the list, at the first malformed color or
+ * once maxCount colors have been read.
+ * 
+ * @param list The list of colors as const char*.
+ * @param separator The char between the colors.
+ * @param rgbs Where to store the colors as 0xRRGGBB values.
+ * @param maxCount The number of colors rgbs has room for.
+ * 
+ * @return Returns the number of colors read as unsigned int.
+*/
+unsigned int Utils::parseRgbHexList(const char *list, char separator, uint32 *rgbs, unsigned int maxCount) {
+    unsigned int count = 0u;
+    while (count < maxCount && rgbHexToDecimal(list, rgbs[count])) {
+        count++;
+        if (list[6] != separator) {
+            break;
+        }
+        list += 7;
+    }
+
+    return count;
 }
 
 /**
- * Splits the given string up into multiple segments based on the given seporator. The
- * split up data segments are stored into a given String based storage array of a specific
- * size. If the storage array is too small for all of the data segments then it will be filled
- * with what it has space for, and the rest will be discarded.
- *
- * @param string - The string to perform the operation on.
- * @param separator - The character to use as a separator for the splitting process.
- * @param storage - An array of strings for storage of the results of the splitting process.
- * @param sizeOfStorage - The size of the storage array provided.
+ * Writes a list of colors such as "RRGGBB:RRGGBB:RRGGBB", the list is
+ * always null terminated and holds as many whole colors as fit.
+ * 
+ * @param rgbs The colors as 0xRRGGBB values.
+ * @param count The number of colors to write.
+ * @param separator The char to put between the colors.
+ * @param list Where to write the list.
+ * @param listSize The number of chars list has room for.
+ * 
+ * @return Returns the length of the written list as size_t.
 */
-void Utils::split(String string, char separator, String *storage, unsigned int sizeOfStorage) {
-  unsigned int index = 0;
-  for (unsigned int segmentIndex = 0; segmentIndex < sizeOfStorage && index < string.length(); segmentIndex++) { // iterate segment storage...
-    unsigned int startIndex = index;
-    for (;index < string.length(); index++) { // increment index though length of the string...
-      if (string.charAt(index) == separator) { // Found a separator...
-        storage[segmentIndex] = string.substring(startIndex, index);
-        index++;
-
-        break; // to allow segmentIndex to increment
-      } else if (index == (string.length() - 1)) { // at the end of the string...
-        index++;
-        storage[segmentIndex] = string.substring(startIndex, index);
-      }
+size_t Utils::formatRgbHexList(const uint32 *rgbs, unsigned int count, char separator, char *list, size_t listSize) {
+    size_t length = 0u;
+    for (unsigned int i = 0u; i < count; i++) {
+        size_t needed = (i == 0u ? 6u : 7u);
+        if (length + needed >= listSize) {
+            break;
+        }
+        if (i > 0u) {
+            list[length++] = separator;
+        }
+        rgbDecimalToHex(rgbs[i], &list[length]);
+        length += 6u;
+    }
+    if (listSize > 0u) {
+        list[length] = '\0';
     }
-  }
-}
\ No newline at end of file
+
+    return length;
+}
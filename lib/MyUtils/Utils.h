@@ -3,56 +3,35 @@
 
     #include <WString.h>
     #include <MD5Builder.h>
-    #include <map>
-
-    static std::map<String, uint8> hexToDecDigitMap {
-        {"0", 0u},
-        {"1", 1u},
-        {"2", 2u},
-        {"3", 3u},
-        {"4", 4u},
-        {"5", 5u},
-        {"6", 6u},
-        {"7", 7u}, 
-        {"8", 8u},
-        {"9", 9u},
-        {"a", 10u},
-        {"b", 11u},
-        {"c", 12u},
-        {"d", 13u},
-        {"e", 14u},
-        {"f", 15u}
-    };
-
-    static std::map<uint8, String> decToHexDigitMap {
-        {0u, "0"},
-        {1u, "1"},
-        {2u, "2"},
-        {3u, "3"},
-        {4u, "4"},
-        {5u, "5"},
-        {6u, "6"},
-        {7u, "7"}, 
-        {8u, "8"},
-        {9u, "9"},
-        {10u, "a"},
-        {11u, "b"},
-        {12u, "c"},
-        {13u, "d"},
-        {14u, "e"},
-        {15u, "f"}
-    };
 
     class Utils {
         private:
+            /**
+             * Gives the value of a single hex digit.
+             * 
+             * @return Returns the value of the digit or 0xFF if it is not
+             * a hex digit as uint8.
+             */
+            static constexpr uint8 hexDigitValue(char c) {
+                return (c >= '0' && c <= '9') ? (uint8) (c - '0')
+                    : (c >= 'a' && c <= 'f') ? (uint8) (c - 'a' + 10)
+                    : (c >= 'A' && c <= 'F') ? (uint8) (c - 'A' + 10)
+                    : 0xFFu;
+            }
+
+            static constexpr char HEX_DIGITS[] = "0123456789abcdef";
 
         public:
             static String hashString(String string);
+            static uint32 crc32(const uint8 *data, size_t length, uint32 crc = 0ul);
             static String genDeviceIdFromMacAddr(String macAddress);
-            static String rgbDecimalsToHex(uint8 red, uint8 green, uint8 blue);
-            static String decimalTo8BitHex(uint8 dec);
-            static uint8 hexTo8BitDecimal(String hex);
-            static void split(String string, char separator, String *storage, unsigned int sizeOfStorage);
+            static void rgbDecimalsToHex(uint8 red, uint8 green, uint8 blue, char *hex);
+            static void decimalTo8BitHex(uint8 dec, char *hex);
+            static bool hexTo8BitDecimal(const char *hex, uint8 &dec);
+            static bool rgbHexToDecimal(const char *hex, uint32 &rgb);
+            static void rgbDecimalToHex(uint32 rgb, char *hex);
+            static unsigned int parseRgbHexList(const char *list, char separator, uint32 *rgbs, unsigned int maxCount);
+            static size_t formatRgbHexList(const uint32 *rgbs, unsigned int count, char separator, char *list, size_t listSize);
     };
 
 #endif
@@ -0,0 +1,101 @@
+/*
+  PageWriter - Streams a web page out to the client in chunks as it is being
+  built. Text, numbers and PROGMEM strings are collected into a small fixed
+  buffer which is sent as a chunk each time it fills, so serving a page needs
+  no heap no matter how large the page is.
+*/
+
+#include <PageWriter.h>
+
+PageWriter::PageWriter(ESP8266WebServer &server) : server(server) {
+    length = 0u;
+}
+
+/**
+ * Sends the response headers, the content that follows is sent
+ * using chunked transfer encoding.
+ * 
+ * @param code - The HTTP response code as int.
+ * @param contentType - The content type of the page as const char*.
+*/
+void PageWriter::begin(int code, const char *contentType) {
+    length = 0u;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(code, contentType, "");
+}
+
+/**
+ * Sends whatever is left in the buffer and ends the response.
+*/
+void PageWriter::end() {
+    flush();
+    server.sendContent("");
+}
+
+void PageWriter::write(char c) {
+    if (length == PAGE_WRITER_BUFFER_SIZE) {
+        flush();
+    }
+    buffer[length++] = c;
+}
+
+void PageWriter::write(const char *text) {
+    while (*text != '\0') {
+        write(*text++);
+    }
+}
+
+void PageWriter::write(unsigned long value) {
+    char digits[11];
+    int i = sizeof(digits);
+    digits[--i] = '\0';
+    do {
+        digits[--i] = '0' + (value % 10ul);
+        value /= 10ul;
+    } while (value > 0ul);
+
+    write(&digits[i]);
+}
+
+/**
+ * Writes the given number of chars from PROGMEM.
+ * 
+ * @param text - The PROGMEM text to write.
+ * @param size - The number of chars to write.
+*/
+void PageWriter::write_P(PGM_P text, size_t size) {
+    while (size > 0u) {
+        if (length == PAGE_WRITER_BUFFER_SIZE) {
+            flush();
+        }
+        size_t count = PAGE_WRITER_BUFFER_SIZE - length;
+        if (count > size) {
+            count = size;
+        }
+        memcpy_P(&buffer[length], text, count);
+        length += count;
+        text += count;
+        size -= count;
+    }
+}
+
+void PageWriter::write_P(PGM_P text) {
+    write_P(text, strlen_P(text));
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Sends the buffered content to the client as a chunk.
+*/
+void PageWriter::flush() {
+    if (length > 0u) {
+        server.sendContent(buffer, length);
+        length = 0u;
+    }
+}
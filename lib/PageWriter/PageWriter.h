@@ -0,0 +1,36 @@
+/*
+  PageWriter - Streams a web page out to the client in chunks as it is being
+  built. Text, numbers and PROGMEM strings are collected into a small fixed
+  buffer which is sent as a chunk each time it fills, so serving a page needs
+  no heap no matter how large the page is.
+*/
+
+#ifndef PageWriter_h
+    #define PageWriter_h
+
+    #include <ESP8266WebServer.h>
+    #include <pgmspace.h>
+
+    #define PAGE_WRITER_BUFFER_SIZE 512
+
+    class PageWriter {
+        private:
+            ESP8266WebServer    &server                                   ;
+            char                buffer     [PAGE_WRITER_BUFFER_SIZE]      ;
+            size_t              length                                    ;
+
+            void flush();
+
+        public:
+            PageWriter(ESP8266WebServer &server);
+
+            void begin(int code, const char *contentType);
+            void end();
+
+            void write(char c);
+            void write(const char *text);
+            void write(unsigned long value);
+            void write_P(PGM_P text, size_t size);
+            void write_P(PGM_P text);
+    };
+#endif
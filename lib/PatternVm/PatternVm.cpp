@@ -0,0 +1,274 @@
+/*
+  PatternVm - Runs small user written programs which work out the color of
+  each pixel, so new patterns can be uploaded rather than flashed. The program
+  is run once for every pixel of a frame on a register machine with 16.16 fixed
+  point values. Programs are checked once when they are loaded, leaving the
+  interpreter free of checks, and are limited to a number of instructions and
+  a time per frame so a runaway program can't hold up the loop. Arithmetic
+  wraps around rather than overflowing, whatever program is uploaded.
+*/
+
+#include <PatternVm.h>
+
+PatternVm::PatternVm() {
+    length = 0u;
+    lastInstructions = 0ul;
+    overBudgetFrames = 0ul;
+}
+
+/**
+ * Reads the program stored in LittleFS, LittleFS must already
+ * be mounted.
+ * 
+ * @return Returns true if a valid program was read otherwise
+ * false, leaving no program, as bool.
+*/
+bool PatternVm::load() {
+    length = 0u;
+    File file = LittleFS.open(PATTERN_FILE, "r");
+    if (!file) {
+        return false;
+    }
+
+    PatternHeader header;
+    uint8 *code = new uint8[PATTERN_MAX_INSTRUCTIONS * PATTERN_INSTRUCTION_SIZE];
+    size_t size = 0u;
+    bool ok = file.read((uint8 *) &header, sizeof(header)) == sizeof(header)
+        && header.magic == PATTERN_MAGIC && header.version == PATTERN_VERSION && header.length <= PATTERN_MAX_INSTRUCTIONS;
+    if (ok) {
+        size = header.length * PATTERN_INSTRUCTION_SIZE;
+        ok = file.read(code, size) == size && header.crc == Utils::crc32(code, size);
+    }
+    file.close();
+    ok = ok && setProgram(code, header.length);
+    delete[] code;
+
+    return ok;
+}
+
+/**
+ * Writes the program to LittleFS.
+ * 
+ * @return Returns true if it was written otherwise false as bool.
+*/
+bool PatternVm::save() {
+    size_t size = length * PATTERN_INSTRUCTION_SIZE;
+    PatternHeader header = {
+        PATTERN_MAGIC,
+        PATTERN_VERSION,
+        0u,
+        (uint16) length,
+        Utils::crc32(program, size)
+    };
+
+    File file = LittleFS.open(PATTERN_FILE, "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = file.write((const uint8 *) &header, sizeof(header)) == sizeof(header)
+        && file.write(program, size) == size;
+    file.close();
+
+    return ok;
+}
+
+/**
+ * Checks and takes the given program. Every instruction must be known,
+ * name registers which exist and jump to within the program or to its
+ * end, so nothing need be checked while it runs.
+ * 
+ * @param program - The instructions, PATTERN_INSTRUCTION_SIZE bytes each.
+ * @param length - The number of instructions.
+ * 
+ * @return Returns true if the program was taken or false, keeping the
+ * current program, as bool.
+*/
+bool PatternVm::setProgram(const uint8 *program, unsigned int length) {
+    if (length > PATTERN_MAX_INSTRUCTIONS) {
+        return false;
+    }
+
+    for (unsigned int pc = 0u; pc < length; pc++) {
+        const uint8 *instruction = &program[pc * PATTERN_INSTRUCTION_SIZE];
+        bool ok;
+        switch (instruction[0]) {
+            case PATTERN_END:
+                ok = true;
+                break;
+            case PATTERN_LDI:
+            case PATTERN_LDF:
+                ok = instruction[1] < PATTERN_REGISTERS;
+                break;
+            case PATTERN_JMP:
+            case PATTERN_JEQ:
+            case PATTERN_JNE:
+            case PATTERN_JLT:
+            case PATTERN_JGE: {
+                long target = (long) pc + 1l + (sint8) instruction[1];
+                ok = target >= 0l && target <= (long) length && instruction[2] < PATTERN_REGISTERS && instruction[3] < PATTERN_REGISTERS;
+                break;
+            }
+            case PATTERN_MOV:
+            case PATTERN_ADD:
+            case PATTERN_SUB:
+            case PATTERN_MUL:
+            case PATTERN_DIV:
+            case PATTERN_MOD:
+            case PATTERN_MIN:
+            case PATTERN_MAX:
+            case PATTERN_FLOOR:
+            case PATTERN_ABS:
+            case PATTERN_TRI:
+            case PATTERN_STEPMOD:
+            case PATTERN_PAL:
+            case PATTERN_RGB:
+                ok = instruction[1] < PATTERN_REGISTERS && instruction[2] < PATTERN_REGISTERS && instruction[3] < PATTERN_REGISTERS;
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    memcpy(this->program, program, length * PATTERN_INSTRUCTION_SIZE);
+    this->length = length;
+
+    return true;
+}
+
+/**
+ * Runs the program for every pixel of a frame. Each pixel starts out
+ * black and keeps the color last output when the program ends. Should
+ * the frame's instructions or time run out, the pixels left are black.
+ * 
+ * Values are added and subtracted as unsigned so they wrap around. The
+ * absolute value of the most negative number, which doesn't fit, is held
+ * at the most positive.
+ * 
+ * @param pixels - Where to write the pixels, three bytes of RGB each.
+ * @param numLeds - The number of pixels.
+ * @param step - The step of the effect, whole so that STEPMOD never jumps.
+ * @param phase - How far into the step in 65536ths.
+ * @param colors - The colors to draw from, three bytes of RGB each.
+ * @param colorsSize - The number of colors.
+*/
+void PatternVm::run(uint8 *pixels, unsigned int numLeds, uint64 step, uint16 phase, const uint8 *colors, unsigned int colorsSize) {
+    unsigned long budget = PATTERN_FRAME_BUDGET;
+    unsigned long start = micros();
+    sint32 r[PATTERN_REGISTERS];
+    memset(pixels, 0, numLeds * 3u);
+
+    for (unsigned int i = 0u; i < numLeds; i++) {
+        uint8 *pixel = &pixels[i * 3u];
+        memset(r, 0, sizeof(r));
+        r[PATTERN_REG_INDEX] = (sint32) i << 16;
+        r[PATTERN_REG_LEDS] = (sint32) numLeds << 16;
+        r[PATTERN_REG_STEP] = (sint32) (step & 0x7FFFul) << 16;
+        r[PATTERN_REG_PHASE] = phase;
+        r[PATTERN_REG_COLORS] = (sint32) colorsSize << 16;
+
+        unsigned int pc = 0u;
+        while (pc < length) {
+            if (budget == 0ul || (budget % PATTERN_CLOCK_INTERVAL == 0ul && micros() - start >= PATTERN_FRAME_MICROS)) {
+                memset(pixel, 0, (numLeds - i) * 3u);
+                overBudgetFrames++;
+                lastInstructions = PATTERN_FRAME_BUDGET - budget;
+
+                return;
+            }
+            budget--;
+
+            const uint8 *instruction = &program[pc * PATTERN_INSTRUCTION_SIZE];
+            uint8 d = instruction[1];
+            sint32 a = r[instruction[2] & 0x0Fu];
+            sint32 b = r[instruction[3] & 0x0Fu];
+            pc++;
+            switch (instruction[0]) {
+                case PATTERN_END: pc = length; break;
+                case PATTERN_LDI: r[d] = (sint32) (sint16) (instruction[2] | (instruction[3] << 8)) * PATTERN_ONE; break;
+                case PATTERN_LDF: r[d] = (sint32) (instruction[2] | (instruction[3] << 8)); break;
+                case PATTERN_MOV: r[d] = a; break;
+                case PATTERN_ADD: r[d] = (sint32) ((uint32) a + (uint32) b); break;
+                case PATTERN_SUB: r[d] = (sint32) ((uint32) a - (uint32) b); break;
+                case PATTERN_MUL: r[d] = (sint32) (((sint64) a * b) >> 16); break;
+                case PATTERN_DIV: r[d] = (b == 0 ? 0 : (sint32) (((sint64) a * PATTERN_ONE) / b)); break;
+                case PATTERN_MOD: {
+                    sint32 m = (b == 0 || b == -1 ? 0 : a % b); // INT32_MIN % -1 overflows
+                    r[d] = (m != 0 && ((m < 0) != (b < 0)) ? m + b : m);
+                    break;
+                }
+                case PATTERN_MIN: r[d] = (a < b ? a : b); break;
+                case PATTERN_MAX: r[d] = (a > b ? a : b); break;
+                case PATTERN_FLOOR: r[d] = a & ~0xFFFF; break;
+                case PATTERN_ABS: r[d] = (a == INT32_MIN ? INT32_MAX : (a < 0 ? -a : a)); break;
+                case PATTERN_TRI: {
+                    sint32 fraction = a & 0xFFFF;
+                    r[d] = (fraction < 0x8000 ? fraction : PATTERN_ONE - fraction) * 2;
+                    break;
+                }
+                case PATTERN_STEPMOD: {
+                    sint32 period = a >> 16;
+                    r[d] = (period < 1 ? 0 : (sint32) (step % (uint32) period) << 16);
+                    break;
+                }
+                case PATTERN_JMP: pc += (sint8) d; break;
+                case PATTERN_JEQ: if (a == b) { pc += (sint8) d; } break;
+                case PATTERN_JNE: if (a != b) { pc += (sint8) d; } break;
+                case PATTERN_JLT: if (a < b) { pc += (sint8) d; } break;
+                case PATTERN_JGE: if (a >= b) { pc += (sint8) d; } break;
+                case PATTERN_PAL: {
+                    if (colorsSize == 0u) {
+                        break;
+                    }
+                    sint32 index = (a >> 16) % (sint32) colorsSize;
+                    const uint8 *color = &colors[(index < 0 ? index + colorsSize : index) * 3u];
+                    uint32 brightness = (b < 0 ? 0 : (b > PATTERN_ONE ? PATTERN_ONE : b));
+                    pixel[0] = (color[0] * brightness + 0x8000u) >> 16;
+                    pixel[1] = (color[1] * brightness + 0x8000u) >> 16;
+                    pixel[2] = (color[2] * brightness + 0x8000u) >> 16;
+                    break;
+                }
+                case PATTERN_RGB:
+                    pixel[0] = toChannel(r[d]);
+                    pixel[1] = toChannel(a);
+                    pixel[2] = toChannel(b);
+                    break;
+            }
+        }
+    }
+
+    lastInstructions = PATTERN_FRAME_BUDGET - budget;
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Converts a value from 0 to 1 into a color channel, values
+ * outside of that are clamped.
+ * 
+ * @param value - The value in 16.16 fixed point as sint32.
+ * 
+ * @return Returns the channel as uint8.
+*/
+uint8 PatternVm::toChannel(sint32 value) {
+    if (value <= 0) {
+        return 0u;
+    }
+    if (value >= PATTERN_ONE) {
+        return 255u;
+    }
+
+    return (uint8) ((value * 255 + 0x8000) >> 16);
+}
+
+const uint8 *PatternVm::getProgram() { return program; }
+unsigned int PatternVm::getLength() { return length; }
+unsigned long PatternVm::getLastInstructions() { return lastInstructions; }
+unsigned long PatternVm::getOverBudgetFrames() { return overBudgetFrames; }
@@ -0,0 +1,107 @@
+/*
+  PatternVm - Runs small user written programs which work out the color of
+  each pixel, so new patterns can be uploaded rather than flashed. The program
+  is run once for every pixel of a frame on a register machine with 16.16 fixed
+  point values. Programs are checked once when they are loaded, leaving the
+  interpreter free of checks, and are limited to a number of instructions and
+  a time per frame so a runaway program can't hold up the loop. Arithmetic
+  wraps around rather than overflowing, whatever program is uploaded.
+*/
+
+#ifndef PatternVm_h
+    #define PatternVm_h
+
+    #include <Arduino.h>
+    #include <LittleFS.h>
+    #include <Utils.h>
+
+    #define PATTERN_FILE "/pattern.bin"
+    #define PATTERN_MAGIC 0x56504253ul // "SBPV"
+    #define PATTERN_VERSION 1u
+    #define PATTERN_MAX_INSTRUCTIONS 256u
+    #define PATTERN_INSTRUCTION_SIZE 4u
+    #define PATTERN_REGISTERS 16u
+    /*
+     * A frame may take a quarter of the 4ms frame interval, leaving the
+     * rest for the output and the network. At up to 40 cycles an instruction
+     * at 160MHz that is 4000 instructions, the time is also checked every
+     * PATTERN_CLOCK_INTERVAL instructions in case they run slower than that.
+     */
+    #define PATTERN_FRAME_BUDGET 4000ul
+    #define PATTERN_FRAME_MICROS 1000ul
+    #define PATTERN_CLOCK_INTERVAL 256ul
+    #define PATTERN_ONE 0x10000l // 1.0 in 16.16 fixed point
+
+    /*
+     * The registers set before each pixel is run, as 16.16 fixed
+     * point values. The rest start out as zero.
+     */
+    #define PATTERN_REG_INDEX 0u // The pixel being worked out
+    #define PATTERN_REG_LEDS 1u // The number of pixels
+    #define PATTERN_REG_STEP 2u // The step of the effect, wrapping at 32768, see PATTERN_STEPMOD
+    #define PATTERN_REG_PHASE 3u // How far into the step, from 0 up to 1
+    #define PATTERN_REG_COLORS 4u // The number of colors in use
+
+    /*
+     * The instructions, each is four bytes: the op followed by
+     * d, a and b. These are uploaded by users so must never be
+     * renumbered. Jumps are relative to the next instruction by
+     * the signed offset in d.
+     */
+    enum PatternOp : uint8 {
+        PATTERN_END = 0x00u, //              Finishes the pixel
+        PATTERN_LDI = 0x01u, // d imm        d = (a | b << 8) as a signed whole number
+        PATTERN_LDF = 0x02u, // d imm        d = (a | b << 8) / 65536
+        PATTERN_MOV = 0x03u, // d a          d = a
+        PATTERN_ADD = 0x04u, // d a b        d = a + b
+        PATTERN_SUB = 0x05u, // d a b        d = a - b
+        PATTERN_MUL = 0x06u, // d a b        d = a * b
+        PATTERN_DIV = 0x07u, // d a b        d = a / b, or 0 when b is 0
+        PATTERN_MOD = 0x08u, // d a b        d = a modulo b from 0 up to b, or 0 when b is 0
+        PATTERN_MIN = 0x09u, // d a b        d = the lesser of a and b
+        PATTERN_MAX = 0x0Au, // d a b        d = the greater of a and b
+        PATTERN_FLOOR = 0x0Bu, // d a        d = the whole part of a
+        PATTERN_ABS = 0x0Cu, // d a          d = a without its sign
+        PATTERN_TRI = 0x0Du, // d a          d = triangle wave of a, 0 at whole numbers and 1 half way between
+        PATTERN_STEPMOD = 0x0Eu, // d a      d = the whole step modulo the whole part of a, or 0 when that is under 1
+        PATTERN_JMP = 0x10u, // off          Jumps
+        PATTERN_JEQ = 0x11u, // off a b      Jumps if a == b
+        PATTERN_JNE = 0x12u, // off a b      Jumps if a != b
+        PATTERN_JLT = 0x13u, // off a b      Jumps if a < b
+        PATTERN_JGE = 0x14u, // off a b      Jumps if a >= b
+        PATTERN_PAL = 0x20u, //  _ a b       Pixel = color (whole part of a modulo the colors in use) at brightness b
+        PATTERN_RGB = 0x21u  // d a b        Pixel = red d, green a and blue b each from 0 to 1
+    };
+
+    class PatternVm {
+        private:
+            struct PatternHeader {
+                uint32           magic                   ;
+                uint8            version                 ;
+                uint8            reserved                ;
+                uint16           length                  ; // In instructions
+                uint32           crc                     ; // CRC32 of the program
+            };
+
+            uint8            program     [PATTERN_MAX_INSTRUCTIONS * PATTERN_INSTRUCTION_SIZE]   ;
+            unsigned int     length                                                              ; // In instructions
+            unsigned long    lastInstructions                                                    ;
+            unsigned long    overBudgetFrames                                                    ;
+
+            static uint8 toChannel(sint32 value);
+
+        public:
+            PatternVm();
+
+            bool load();
+            bool save();
+            bool setProgram(const uint8 *program, unsigned int length);
+            void run(uint8 *pixels, unsigned int numLeds, uint64 step, uint16 phase, const uint8 *colors, unsigned int colorsSize);
+
+            // Getters defined below
+            const uint8         *getProgram             ();
+            unsigned int        getLength               ();
+            unsigned long       getLastInstructions     ();
+            unsigned long       getOverBudgetFrames     ();
+    };
+#endif
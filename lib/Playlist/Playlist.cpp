@@ -0,0 +1,169 @@
+/*
+  Playlist - Steps through a list of looks, each an effect with its colors
+  and speed, showing each for a set time and fading into the next. The list
+  is kept in LittleFS in the same fixed binary form it is used in, so it is
+  read once at boot and stepping through it needs no parsing or allocation.
+*/
+
+#include <Playlist.h>
+
+Playlist::Playlist() {
+    count = 0u;
+    current = 0u;
+    playing = false;
+    started = false;
+    entryStartMillis = 0ul;
+}
+
+/**
+ * Tells whether an entry holds only values PUT /api/playlist accepts:
+ * a known effect, one to PLAYLIST_MAX_COLORS colors, a step of at most
+ * the given length and a look shown for at least a second.
+ * 
+ * @param entry - The entry to check.
+ * @param effectCount - The number of effects, IDs run from 0 to one less.
+ * @param maxStepMicros - The longest step allowed.
+ * 
+ * @return Returns true if the entry is valid otherwise false as bool.
+*/
+bool Playlist::isValidEntry(const PlaylistEntry &entry, unsigned int effectCount, unsigned long maxStepMicros) {
+    return entry.effectId < effectCount
+        && entry.colorsSize >= 1u && entry.colorsSize <= PLAYLIST_MAX_COLORS
+        && entry.reserved == 0u
+        && entry.stepMicros <= maxStepMicros
+        && entry.seconds >= 1u;
+}
+
+/**
+ * Reads the playlist stored in LittleFS, LittleFS must already
+ * be mounted. The file is refused as a whole if any of its entries
+ * isn't valid, see isValidEntry().
+ * 
+ * @param effectCount - The number of effects, IDs run from 0 to one less.
+ * @param maxStepMicros - The longest step allowed.
+ * 
+ * @return Returns true if a valid playlist was read otherwise
+ * false, leaving the playlist empty, as bool.
+*/
+bool Playlist::load(unsigned int effectCount, unsigned long maxStepMicros) {
+    count = 0u;
+    playing = false;
+    File file = LittleFS.open(PLAYLIST_FILE, "r");
+    if (!file) {
+        return false;
+    }
+
+    PlaylistHeader header;
+    bool ok = file.read((uint8 *) &header, sizeof(header)) == sizeof(header)
+        && header.magic == PLAYLIST_MAGIC && header.version == PLAYLIST_VERSION && header.count <= PLAYLIST_MAX_ENTRIES && header.reserved == 0u
+        && file.read((uint8 *) entries, header.count * sizeof(PlaylistEntry)) == header.count * sizeof(PlaylistEntry)
+        && header.crc == Utils::crc32((const uint8 *) entries, header.count * sizeof(PlaylistEntry));
+    file.close();
+    for (unsigned int i = 0u; ok && i < header.count; i++) {
+        ok = isValidEntry(entries[i], effectCount, maxStepMicros);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    count = header.count;
+    if (header.flags & PLAYLIST_FLAG_PLAYING) {
+        play();
+    }
+
+    return true;
+}
+
+/**
+ * Writes the playlist, and whether it is playing, to LittleFS.
+ * 
+ * @return Returns true if it was written otherwise false as bool.
+*/
+bool Playlist::save() {
+    PlaylistHeader header = {
+        PLAYLIST_MAGIC,
+        PLAYLIST_VERSION,
+        (uint8) count,
+        (uint8) (playing ? PLAYLIST_FLAG_PLAYING : 0u),
+        0u,
+        Utils::crc32((const uint8 *) entries, count * sizeof(PlaylistEntry))
+    };
+
+    File file = LittleFS.open(PLAYLIST_FILE, "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = file.write((const uint8 *) &header, sizeof(header)) == sizeof(header)
+        && file.write((const uint8 *) entries, count * sizeof(PlaylistEntry)) == count * sizeof(PlaylistEntry);
+    file.close();
+
+    return ok;
+}
+
+/**
+ * Replaces the entries of the playlist, which starts again from
+ * its first entry if it is playing.
+ * 
+ * @param entries - The new entries.
+ * @param count - The number of entries.
+ * 
+ * @return Returns true if the entries were taken or false if there
+ * were more than PLAYLIST_MAX_ENTRIES as bool.
+*/
+bool Playlist::setEntries(const PlaylistEntry *entries, unsigned int count) {
+    if (count > PLAYLIST_MAX_ENTRIES) {
+        return false;
+    }
+    memcpy(this->entries, entries, count * sizeof(PlaylistEntry));
+    this->count = count;
+    current = 0u;
+    started = false;
+    if (count == 0u) {
+        playing = false;
+    }
+
+    return true;
+}
+
+/**
+ * Starts playing from the first entry.
+*/
+void Playlist::play() {
+    playing = (count > 0u);
+    current = 0u;
+    started = false;
+}
+
+void Playlist::stop() {
+    playing = false;
+}
+
+/**
+ * Moves the playlist along, this is meant to be called regularly
+ * from the application's loop.
+ * 
+ * @param nowMillis - The current time in millis.
+ * 
+ * @return Returns the entry to change to when it is time to change,
+ * otherwise nullptr, as const PlaylistEntry*.
+*/
+const PlaylistEntry *Playlist::service(unsigned long nowMillis) {
+    if (!playing) {
+        return nullptr;
+    }
+    if (started) {
+        if (nowMillis - entryStartMillis < entries[current].seconds * 1000ul) {
+            return nullptr;
+        }
+        current = (current + 1u) % count;
+    }
+    started = true;
+    entryStartMillis = nowMillis;
+
+    return &entries[current];
+}
+
+bool Playlist::isPlaying() { return playing; }
+unsigned int Playlist::getCount() { return count; }
+unsigned int Playlist::getCurrent() { return current; }
+const PlaylistEntry *Playlist::getEntry(unsigned int index) { return (index < count ? &entries[index] : nullptr); }
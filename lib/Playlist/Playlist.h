@@ -0,0 +1,72 @@
+/*
+  Playlist - Steps through a list of looks, each an effect with its colors
+  and speed, showing each for a set time and fading into the next. The list
+  is kept in LittleFS in the same fixed binary form it is used in, so it is
+  read once at boot and stepping through it needs no parsing or allocation.
+*/
+
+#ifndef Playlist_h
+    #define Playlist_h
+
+    #include <Arduino.h>
+    #include <LittleFS.h>
+    #include <Utils.h>
+
+    #define PLAYLIST_FILE "/playlist.bin"
+    #define PLAYLIST_MAGIC 0x4C504253ul // "SBPL"
+    #define PLAYLIST_VERSION 1u
+    #define PLAYLIST_MAX_ENTRIES 16u
+    #define PLAYLIST_MAX_COLORS 3u
+
+    #define PLAYLIST_FLAG_PLAYING 0x01u
+
+    /**
+     * One look of a playlist.
+     */
+    struct PlaylistEntry {
+        uint8            effectId                                    ;
+        uint8            colorsSize                                  ;
+        uint8            colors         [PLAYLIST_MAX_COLORS][3]     ; // RGB
+        uint8            reserved                                    ; // Always 0
+        uint32           stepMicros                                  ;
+        uint16           seconds                                     ; // How long the look is shown for
+        uint16           fadeMillis                                  ; // How long it takes to fade in
+    };
+
+    class Playlist {
+        private:
+            struct PlaylistHeader {
+                uint32           magic                   ;
+                uint8            version                 ;
+                uint8            count                   ;
+                uint8            flags                   ;
+                uint8            reserved                ; // Always 0
+                uint32           crc                     ; // CRC32 of the entries
+            };
+
+            PlaylistEntry    entries     [PLAYLIST_MAX_ENTRIES]      ;
+            unsigned int     count                                   ;
+            unsigned int     current                                 ;
+            bool             playing                                 ;
+            bool             started                                 ; // The current entry has been handed out
+            unsigned long    entryStartMillis                        ;
+
+        public:
+            Playlist();
+
+            static bool isValidEntry(const PlaylistEntry &entry, unsigned int effectCount, unsigned long maxStepMicros);
+
+            bool load(unsigned int effectCount, unsigned long maxStepMicros);
+            bool save();
+            bool setEntries(const PlaylistEntry *entries, unsigned int count);
+            void play();
+            void stop();
+            const PlaylistEntry *service(unsigned long nowMillis);
+
+            // Getters defined below
+            bool                    isPlaying       ();
+            unsigned int            getCount        ();
+            unsigned int            getCurrent      ();
+            const PlaylistEntry     *getEntry       (unsigned int index);
+    };
+#endif
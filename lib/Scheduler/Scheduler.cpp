@@ -0,0 +1,145 @@
+/*
+  Scheduler - A small cooperative scheduler which gives a render task a
+  fixed per-frame deadline and spends the time left over between frames
+  on background work such as servicing the network. Frames are scheduled
+  on absolute times so a slow background task delays at most the next
+  frame, it never shifts the ones after it. Once the background work is
+  done the scheduler sleeps until the next frame is near.
+*/
+
+#include <Scheduler.h>
+
+Scheduler::Scheduler(unsigned long frameIntervalMicros) {
+    this->frameIntervalMicros = frameIntervalMicros;
+    nextFrameMicros = 0ul;
+    renderTask = nullptr;
+    backgroundTaskCount = 0u;
+
+    frameCount = 0ul;
+    missedDeadlines = 0ul;
+    skippedFrames = 0ul;
+    maxLatenessMicros = 0ul;
+    idleMillis = 0ul;
+    idleRemainderMicros = 0ul;
+    lastSleepMicros = 0ul;
+}
+
+/**
+ * Sets the task which is run once per frame.
+ * 
+ * @param task - The function to call for each frame.
+*/
+void Scheduler::setRenderTask(void (*task)()) {
+    renderTask = task;
+    nextFrameMicros = micros();
+}
+
+/**
+ * Changes how often frames are due, this takes effect from
+ * the next frame.
+ * 
+ * @param frameIntervalMicros - The time between frames in micros.
+*/
+void Scheduler::setFrameIntervalMicros(unsigned long frameIntervalMicros) {
+    this->frameIntervalMicros = frameIntervalMicros;
+}
+
+/**
+ * Adds a task to be run in the time left over between frames. Background
+ * tasks are run in the order they were added.
+ * 
+ * @param task - The function to call between frames.
+ * 
+ * @return Returns true if the task was added or false if there was no room
+ * for it as bool.
+*/
+bool Scheduler::addBackgroundTask(void (*task)()) {
+    if (backgroundTaskCount >= MAX_BACKGROUND_TASKS) {
+        return false;
+    }
+    backgroundTasks[backgroundTaskCount++] = task;
+
+    return true;
+}
+
+/**
+ * Performs a single pass of the scheduler, this is meant to be called
+ * from the application's loop. When a frame is due the render task is run,
+ * otherwise the background tasks are given their turn. If the next frame
+ * is still some way off after that, the scheduler sleeps for a milli, which
+ * hands the time to the WiFi stack rather than spinning.
+*/
+void Scheduler::run() {
+    lastSleepMicros = 0ul;
+    unsigned long now = micros();
+    if (renderTask != nullptr && (long)(now - nextFrameMicros) >= 0l) {
+        runFrame(now);
+
+        return;
+    }
+
+    runBackgroundTasks();
+    unsigned long sleepStart = micros();
+    if (renderTask != nullptr && (long)(nextFrameMicros - sleepStart) > (long) SCHEDULER_SLEEP_MARGIN_MICROS) {
+        delay(1);
+        lastSleepMicros = micros() - sleepStart;
+        idleRemainderMicros += lastSleepMicros;
+        idleMillis += idleRemainderMicros / 1000ul;
+        idleRemainderMicros %= 1000ul;
+    }
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Runs the render task for the frame which is due and works out when
+ * the next one is due. A frame which finishes after the end of its slot
+ * counts as a missed deadline, and any slots which passed entirely while
+ * the scheduler was busy are skipped rather than played late.
+ * 
+ * @param now - The time the frame was started in micros.
+*/
+void Scheduler::runFrame(unsigned long now) {
+    unsigned long lateness = now - nextFrameMicros;
+    if (lateness > maxLatenessMicros) {
+        maxLatenessMicros = lateness;
+    }
+
+    renderTask();
+    frameCount++;
+
+    unsigned long finished = micros();
+    if (finished - nextFrameMicros > frameIntervalMicros) {
+        missedDeadlines++;
+    }
+
+    nextFrameMicros += frameIntervalMicros;
+    if ((long)(finished - nextFrameMicros) >= 0l) {
+        unsigned long behind = (finished - nextFrameMicros) / frameIntervalMicros + 1ul;
+        skippedFrames += behind;
+        nextFrameMicros += behind * frameIntervalMicros;
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Gives each of the background tasks a turn.
+*/
+void Scheduler::runBackgroundTasks() {
+    for (unsigned int i = 0u; i < backgroundTaskCount; i++) {
+        backgroundTasks[i]();
+    }
+}
+
+unsigned long Scheduler::getFrameIntervalMicros() { return frameIntervalMicros; }
+unsigned long Scheduler::getFrameCount() { return frameCount; }
+unsigned long Scheduler::getMissedDeadlines() { return missedDeadlines; }
+unsigned long Scheduler::getSkippedFrames() { return skippedFrames; }
+unsigned long Scheduler::getMaxLatenessMicros() { return maxLatenessMicros; }
+unsigned long Scheduler::getIdleMillis() { return idleMillis; }
+unsigned long Scheduler::getLastSleepMicros() { return lastSleepMicros; }
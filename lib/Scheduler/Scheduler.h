@@ -0,0 +1,54 @@
+/*
+  Scheduler - A small cooperative scheduler which gives a render task a
+  fixed per-frame deadline and spends the time left over between frames
+  on background work such as servicing the network. Frames are scheduled
+  on absolute times so a slow background task delays at most the next
+  frame, it never shifts the ones after it. Once the background work is
+  done the scheduler sleeps until the next frame is near.
+*/
+
+#ifndef Scheduler_h
+    #define Scheduler_h
+
+    #include <Arduino.h>
+
+    #define MAX_BACKGROUND_TASKS 8
+    #define SCHEDULER_SLEEP_MARGIN_MICROS 1500ul // Only sleep when the next frame is further off than this
+
+    class Scheduler {
+        private:
+            unsigned long    frameIntervalMicros                             ;
+            unsigned long    nextFrameMicros                                 ;
+            void             (*renderTask)()                                 ;
+            void             (*backgroundTasks[MAX_BACKGROUND_TASKS])()      ;
+            unsigned int     backgroundTaskCount                             ;
+
+            unsigned long    frameCount                                      ;
+            unsigned long    missedDeadlines                                 ;
+            unsigned long    skippedFrames                                   ;
+            unsigned long    maxLatenessMicros                               ;
+            unsigned long    idleMillis                                      ; // Time spent asleep between frames
+            unsigned long    idleRemainderMicros                             ;
+            unsigned long    lastSleepMicros                                 ; // Time spent asleep in the last pass
+
+            void runFrame(unsigned long now);
+            void runBackgroundTasks();
+
+        public:
+            Scheduler(unsigned long frameIntervalMicros);
+
+            void setRenderTask(void (*task)());
+            void setFrameIntervalMicros(unsigned long frameIntervalMicros);
+            bool addBackgroundTask(void (*task)());
+            void run();
+
+            // Getters defined below
+            unsigned long    getFrameIntervalMicros     ();
+            unsigned long    getFrameCount              ();
+            unsigned long    getMissedDeadlines         ();
+            unsigned long    getSkippedFrames           ();
+            unsigned long    getMaxLatenessMicros       ();
+            unsigned long    getIdleMillis              ();
+            unsigned long    getLastSleepMicros         ();
+    };
+#endif
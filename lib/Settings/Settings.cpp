@@ -12,8 +12,29 @@
 
 #include <Settings.h>
 
+// The CRC covers everything that follows the header
+#define CRC_START offsetof(NVSettings, actionId)
+
+/*
+ * The action names used by the 2.0.0 settings layout,
+ * indexed by the action IDs which replaced them.
+ */
+static const char LEGACY_ACTION_NAMES[][24] PROGMEM = {
+    "allOff",
+    "solidColors",
+    "flashingColors",
+    "oneDirectionChase",
+    "backAndForthChase",
+    "inwardChevronChase"
+};
+
 Settings::Settings() {
     defaultSettings();
+    memset(&persistedSettings, 0, sizeof(NVSettings));
+    savePending = false;
+    saveRequestedMillis = 0ul;
+    saveCount = 0ul;
+    skippedSaveCount = 0ul;
 }
 
 /**
@@ -33,55 +54,108 @@ bool Settings::factoryDefault() {
 
 /**
  * Used to save or persist the current value of the non-volatile settings
- * into flash memory.
+ * into flash memory. Nothing is written when the settings are unchanged
+ * since they were last loaded or saved.
+ * 
+ * The sector is deliberately not wiped first, ESP_EEPROM writes each commit
+ * into the next free slot of its flash sector and only erases the sector
+ * once every slot has been used. With a record this small that spreads
+ * wear over more than eighty saves per erase.
  *
  * @return Returns a true if save was successful otherwise a false as bool.
 */
 bool Settings::saveSettings() {
-    strcpy(nvSettings.sentinel, hashNvSettings(nvSettings).c_str()); // Ensure accurate Sentinel Value.
-    EEPROM.begin(sizeof(NVSettings));
+    savePending = false;
+    nvSettings.magic = SETTINGS_MAGIC;
+    nvSettings.version = SETTINGS_VERSION;
+    nvSettings.length = sizeof(NVSettings);
+    nvSettings.crc = crcNvSettings(nvSettings, nvSettings.length); // Ensure accurate CRC.
+    if (memcmp(&nvSettings, &persistedSettings, sizeof(NVSettings)) == 0) {
+        skippedSaveCount++;
 
-    EEPROM.wipe(); // usage seemd to grow without this.
+        return true;
+    }
+
+    EEPROM.begin(SETTINGS_STORAGE_SIZE);
     EEPROM.put(0, nvSettings);
     
     bool ok = EEPROM.commit();
 
     EEPROM.end();
+
+    if (ok) {
+        persistedSettings = nvSettings;
+        saveCount++;
+    }
     
     return ok;
 }
 
+/**
+ * Asks for the current settings to be saved once they have stopped
+ * changing. Each request restarts the wait, so a burst of changes ends
+ * up as a single write to flash made by service().
+*/
+void Settings::requestSave() {
+    if (savePending) {
+        skippedSaveCount++;
+    }
+    savePending = true;
+    saveRequestedMillis = millis();
+}
+
+/**
+ * Writes a requested save to flash once no further changes have been
+ * requested for SETTINGS_SAVE_DELAY_MILLIS. This is meant to be called
+ * regularly from the application's loop.
+ * 
+ * @return Returns true if a save was written otherwise false as bool.
+*/
+bool Settings::service() {
+    if (!savePending || millis() - saveRequestedMillis < SETTINGS_SAVE_DELAY_MILLIS) {
+        return false;
+    }
+
+    return saveSettings();
+}
+
 /**
  * Used to load the settings from flash memory.
- * After the settings are loaded from flash memory the sentinel value is 
- * checked to ensure the integrity of the loaded data. If the sentinel 
- * value is wrong then the contents of the memory are deemed invalid and
- * the memory is wiped and then a factory default is instead performed.
+ * After the settings are loaded from flash memory their magic number, 
+ * length and CRC are checked to ensure the integrity of the loaded data.
+ * Fields which the stored record is too short to hold keep their factory
+ * value. If the record is not valid but the memory holds settings saved
+ * by older firmware then those are migrated, otherwise the contents of the
+ * memory are deemed invalid and a factory default is instead performed.
  * 
- * @return Returns true if data was loaded from memory and the sentinel 
- * value was valid.
+ * @return Returns true if valid settings were loaded from memory.
 */
 bool Settings::loadSettings() {
     bool ok = false;
     // Setup EEPROM for loading and saving...
-    EEPROM.begin(sizeof(NVSettings));
+    EEPROM.begin(SETTINGS_STORAGE_SIZE);
 
     // Persist default settings or load settings...
     delay(15);
 
     /* Load from EEPROM if applicable... */
     if (EEPROM.percentUsed() >= 0) { // Something is stored from prior...
-        EEPROM.get(0, nvSettings);
-        if (strcmp(nvSettings.sentinel, hashNvSettings(nvSettings).c_str()) != 0) { // Memory is corrupt...
-            EEPROM.wipe();
-            factoryDefault();
-        } else { // Memory seems ok...
-            ok = true;
-        }
+        uint8 stored[SETTINGS_STORAGE_SIZE];
+        EEPROM.get(0, stored);
+        ok = readNvSettings(stored);
     }
     
     EEPROM.end();
 
+    if (!ok) {
+        if (loadVersion1Settings() || loadLegacySettings()) { // Settings from older firmware...
+            ok = true;
+            saveSettings();
+        } else { // Memory is corrupt...
+            factoryDefault();
+        }
+    }
+
     return ok;
 }
 
@@ -99,21 +173,146 @@ Private Functions BELOW
 */
 void Settings::defaultSettings() {
     // Default the settings..
-    strcpy(nvSettings.actionName, factorySettings.actionName);
-    nvSettings.actionDelay = factorySettings.actionDelay;
-    strcpy(nvSettings.colors, factorySettings.colors);
-    nvSettings.colorsSize = factorySettings.colorsSize;
+    nvSettings = factorySettings;
+}
+
+/**
+ * #### PRIVATE ####
+ * Used to calculate the CRC of the given NonVolatileSettings, this
+ * covers every field after the crc field up to the given length.
+ * 
+ * @param nvSet An instance of NonVolatileSettings to calculate a CRC for.
+ * @param length The length of the record in bytes.
+ * 
+ * @return Returns the calculated CRC as uint32.
+*/
+uint32 Settings::crcNvSettings(const struct NVSettings &nvSet, size_t length) {
+    return Utils::crc32(((const uint8 *) &nvSet) + CRC_START, length - CRC_START);
+}
+
+/**
+ * #### PRIVATE ####
+ * Checks the settings record read from flash and takes its values
+ * when it is intact. The record may have been stored by an older or
+ * newer version, only the fields both versions know of are used.
+ * 
+ * @param stored The raw record as read from flash.
+ * 
+ * @return Returns true if the settings were used otherwise false as bool.
+*/
+bool Settings::readNvSettings(const uint8 *stored) {
+    NVSettings header;
+    memcpy(&header, stored, CRC_START);
+    if (header.magic != SETTINGS_MAGIC || header.version < 2u || header.length < CRC_START || header.length > SETTINGS_STORAGE_SIZE) {
+        return false;
+    }
+    if (header.crc != Utils::crc32(stored + CRC_START, header.length - CRC_START)) {
+        return false;
+    }
+
+    NVSettings loaded = factorySettings;
+    memcpy(&loaded, stored, header.length < sizeof(NVSettings) ? header.length : sizeof(NVSettings));
+    if (loaded.colorsSize < 1u || loaded.colorsSize > MAX_SETTINGS_COLORS) {
+        return false;
+    }
+
+    loaded.syncLeaderId[SYNC_LEADER_ID_SIZE - 1u] = '\0';
+    nvSettings = loaded;
+    persistedSettings = loaded;
+    if (header.length < offsetof(NVSettings, actionDelayMicros) + sizeof(loaded.actionDelayMicros)) { // Older than version 3
+        setActionDelay(loaded.actionDelay);
+    }
+
+    return true;
+}
+
+/**
+ * #### PRIVATE ####
+ * Loads settings saved in the version 1 layout, converting them into
+ * the current settings. Nothing is persisted by this function.
+ * 
+ * @return Returns true if valid version 1 settings were found otherwise
+ * false as bool.
+*/
+bool Settings::loadVersion1Settings() {
+    bool ok = false;
+    EEPROM.begin(sizeof(NVSettingsV1));
+
+    if (EEPROM.percentUsed() >= 0) {
+        NVSettingsV1 v1;
+        EEPROM.get(0, v1);
+        if (v1.magic == SETTINGS_MAGIC && v1.version == 1u && v1.crc == Utils::crc32((const uint8 *) &v1, offsetof(NVSettingsV1, crc))) {
+            defaultSettings();
+            nvSettings.actionId = v1.actionId;
+            setActionDelay(v1.actionDelay);
+            memcpy(nvSettings.colors, v1.colors, sizeof(v1.colors));
+            setColorsSize(v1.colorsSize);
+
+            ok = true;
+        }
+    }
+
+    EEPROM.end();
+
+    return ok;
+}
+
+/**
+ * #### PRIVATE ####
+ * Loads settings saved in the text based layout used by firmware 2.0.0
+ * and earlier, converting them into the current settings. Nothing is
+ * persisted by this function.
+ * 
+ * @return Returns true if valid legacy settings were found otherwise
+ * false as bool.
+*/
+bool Settings::loadLegacySettings() {
+    bool ok = false;
+    EEPROM.begin(sizeof(LegacyNVSettings));
+
+    if (EEPROM.percentUsed() >= 0) {
+        LegacyNVSettings legacy;
+        EEPROM.get(0, legacy);
+        legacy.actionName[sizeof(legacy.actionName) - 1] = '\0';
+        legacy.colors[sizeof(legacy.colors) - 1] = '\0';
+        legacy.sentinel[sizeof(legacy.sentinel) - 1] = '\0';
+
+        if (strcmp(legacy.sentinel, hashLegacyNvSettings(legacy).c_str()) == 0) {
+            defaultSettings();
+            for (unsigned int i = 0u; i < sizeof(LEGACY_ACTION_NAMES) / sizeof(LEGACY_ACTION_NAMES[0]); i++) {
+                if (strcmp_P(legacy.actionName, LEGACY_ACTION_NAMES[i]) == 0) {
+                    nvSettings.actionId = i;
+                    break;
+                }
+            }
+            setActionDelay(legacy.actionDelay);
+
+            uint32 colors[MAX_SETTINGS_COLORS];
+            unsigned int count = Utils::parseRgbHexList(legacy.colors, ':', colors, MAX_SETTINGS_COLORS);
+            for (unsigned int i = 0u; i < count; i++) {
+                setColor(i, colors[i]);
+            }
+            setColorsSize(legacy.colorsSize);
+
+            ok = true;
+        }
+    }
+
+    EEPROM.end();
+
+    return ok;
 }
 
 /**
  * #### PRIVATE ####
- * Used to provide a hash of the given NonVolatileSettings.
+ * Used to provide a hash of the given LegacyNVSettings, this is the
+ * sentinel that firmware 2.0.0 and earlier stored with them.
  * 
- * @param nvSet An instance of NonVolatileSettings to calculate a hash for.
+ * @param nvSet An instance of LegacyNVSettings to calculate a hash for.
  * 
  * @return Returns the calculated hash value as String.
 */
-String Settings::hashNvSettings(NVSettings nvSet) {
+String Settings::hashLegacyNvSettings(const struct LegacyNVSettings &nvSet) {
     String content = "";
     content = content + String(nvSet.actionName);
     content = content + String(nvSet.actionDelay);
@@ -128,12 +327,68 @@ String Settings::hashNvSettings(NVSettings nvSet) {
     return builder.toString();
 }
 
-String Settings::getActionName() { return nvSettings.actionName; }
-unsigned long Settings::getActionDelay() { return nvSettings.actionDelay; }
-String Settings::getColors() { return nvSettings.colors; }
+unsigned char Settings::getActionId() { return nvSettings.actionId; }
+unsigned long Settings::getActionDelayMicros() { return nvSettings.actionDelayMicros; }
 unsigned int Settings::getColorsSize() { return nvSettings.colorsSize; }
+unsigned int Settings::getLedCount() { return nvSettings.ledCount; }
+unsigned char Settings::getDataPin() { return nvSettings.dataPin; }
+unsigned char Settings::getColorOrder() { return nvSettings.colorOrder; }
+unsigned char Settings::getSyncRole() { return nvSettings.syncRole; }
+const char* Settings::getSyncLeaderId() { return nvSettings.syncLeaderId; }
+unsigned long Settings::getSaveCount() { return saveCount; }
+unsigned long Settings::getSkippedSaveCount() { return skippedSaveCount; }
+
+/**
+ * Gets one of the stored colors.
+ * 
+ * @param index The index of the color.
+ * 
+ * @return Returns the color as a 0xRRGGBB value, or 0 if the index
+ * is out of range, as uint32.
+*/
+uint32 Settings::getColor(unsigned int index) {
+    if (index >= MAX_SETTINGS_COLORS) {
+        return 0ul;
+    }
+    const uint8 *rgb = nvSettings.colors[index];
+
+    return ((uint32) rgb[0] << 16) | ((uint32) rgb[1] << 8) | rgb[2];
+}
 
-void Settings::setActionName(String actionName) { strcpy(nvSettings.actionName, actionName.c_str()); }
-void Settings::setActionDelay(unsigned long actionDelay) { nvSettings.actionDelay = actionDelay; }
-void Settings::setColors(String colors) { strcpy(nvSettings.colors, colors.c_str()); }
-void Settings::setColorsSize(unsigned int colorsSize) { nvSettings.colorsSize = colorsSize; }
\ No newline at end of file
+void Settings::setActionId(unsigned char actionId) { nvSettings.actionId = actionId; }
+void Settings::setActionDelay(unsigned long delayMillis) {
+    setActionDelayMicros(delayMillis > ULONG_MAX / 1000ul ? ULONG_MAX : delayMillis * 1000ul);
+}
+
+void Settings::setActionDelayMicros(unsigned long delayMicros) {
+    nvSettings.actionDelayMicros = delayMicros;
+    nvSettings.actionDelay = delayMicros / 1000ul;
+}
+
+void Settings::setColor(unsigned int index, uint32 rgb) {
+    if (index < MAX_SETTINGS_COLORS) {
+        nvSettings.colors[index][0] = (rgb >> 16) & 0xFF;
+        nvSettings.colors[index][1] = (rgb >> 8) & 0xFF;
+        nvSettings.colors[index][2] = rgb & 0xFF;
+    }
+}
+
+void Settings::setColorsSize(unsigned int colorsSize) {
+    if (colorsSize < 1u) {
+        colorsSize = 1u;
+    } else if (colorsSize > MAX_SETTINGS_COLORS) {
+        colorsSize = MAX_SETTINGS_COLORS;
+    }
+    nvSettings.colorsSize = colorsSize; 
+}
+
+void Settings::setLedCount(unsigned int ledCount) { nvSettings.ledCount = ledCount; }
+void Settings::setDataPin(unsigned char dataPin) { nvSettings.dataPin = dataPin; }
+void Settings::setColorOrder(unsigned char colorOrder) { nvSettings.colorOrder = colorOrder; }
+
+void Settings::setSyncRole(unsigned char syncRole) { nvSettings.syncRole = syncRole; }
+
+void Settings::setSyncLeaderId(const char *leaderId) {
+    strncpy(nvSettings.syncLeaderId, leaderId, SYNC_LEADER_ID_SIZE - 1u);
+    nvSettings.syncLeaderId[SYNC_LEADER_ID_SIZE - 1u] = '\0';
+}
@@ -13,48 +13,138 @@
 #ifndef Settings_h
     #define Settings_h
 
+    #include <stddef.h>
+    #include <limits.h>
     #include <WString.h>
     #include <ESP_EEPROM.h>
     #include <MD5Builder.h>
+    #include <Utils.h>
+
+    #define SETTINGS_MAGIC 0x54534253ul // "SBST"
+    #define SETTINGS_VERSION 4u
+    #define SETTINGS_STORAGE_SIZE 48u // Fixed so that newer versions can grow the record in place
+    #define MAX_SETTINGS_COLORS 3u
+    #define SYNC_LEADER_ID_SIZE 7u // Device ID of 6 chars + 1
+    #define SETTINGS_SAVE_DELAY_MILLIS 2000ul // Quiet time before a requested save is written
 
     class Settings {
         private:
+            /*
+             * From version 2 on the record only ever grows by adding fields
+             * to its end. A record written by an older version is loaded by
+             * reading the length it was stored with and taking factory values
+             * for any fields after that.
+             */
             struct NVSettings {
+                uint32           magic                                       ;
+                uint8            version                                     ;
+                uint8            reserved                                    ;
+                uint16           length                                      ; // Bytes in the record as stored
+                uint32           crc                                         ; // CRC32 of the bytes after this up to length
+                uint8            actionId                                    ;
+                uint8            colorsSize                                  ;
+                uint8            colorOrder                                  ;
+                uint8            dataPin                                     ;
+                uint32           actionDelay                                 ; // Millis, kept for older firmware
+                uint16           ledCount                                    ;
+                uint8            colors         [MAX_SETTINGS_COLORS][3]     ; // RGB
+                uint8            padding        [1]                          ; // Always 0
+                uint32           actionDelayMicros                           ; // Since version 3
+                uint8            syncRole                                    ; // Since version 4
+                char             syncLeaderId   [SYNC_LEADER_ID_SIZE]        ; // Since version 4
+            } nvSettings, persistedSettings;
+            static_assert(sizeof(NVSettings) <= SETTINGS_STORAGE_SIZE, "Settings no longer fit in SETTINGS_STORAGE_SIZE");
+
+            bool             savePending             ;
+            unsigned long    saveRequestedMillis     ;
+            unsigned long    saveCount               ; // Saves actually written to flash
+            unsigned long    skippedSaveCount        ; // Saves requested which were merged or unchanged
+
+            /*
+             * The layout of version 1 settings, only ever read to migrate them.
+             */
+            struct NVSettingsV1 {
+                uint32           magic                                       ;
+                uint8            version                                     ;
+                uint8            actionId                                    ;
+                uint8            colorsSize                                  ;
+                uint8            reserved                                    ;
+                uint32           actionDelay                                 ;
+                uint8            colors         [MAX_SETTINGS_COLORS][3]     ; // RGB
+                uint8            padding        [3]                          ; // Keeps crc aligned, always 0
+                uint32           crc                                         ; // CRC32 of all of the above
+            };
+
+            /*
+             * The layout settings were stored in by firmware 2.0.0 and
+             * earlier, only ever read to migrate them.
+             */
+            struct LegacyNVSettings {
                 char             actionName     [100]    ;
                 unsigned long    actionDelay             ;
                 char             colors         [100]    ;
                 unsigned int     colorsSize              ;
                 char             sentinel       [33]     ; // Holds a 32 MD5 hash + 1
-            } nvSettings;
+            };
 
             struct NVSettings factorySettings = {
-                "flashingColors", // <------------ actionName
-                70ul, // <------------------------ actionDelay
-                "0000FF:000000:000000", // <------ colors
+                SETTINGS_MAGIC, // <-------------- magic
+                SETTINGS_VERSION, // <------------ version
+                0u, // <-------------------------- reserved
+                sizeof(NVSettings), // <---------- length
+                0ul, // <------------------------- crc
+                2u, // <-------------------------- actionId (Flashing Colors)
                 1u, // <-------------------------- colorsSize
-                "NA" // <------------------------- sentinel
+                2u, // <-------------------------- colorOrder (GRB)
+                5u, // <-------------------------- dataPin
+                70ul, // <------------------------ actionDelay
+                11u, // <------------------------- ledCount
+                {{0x00, 0x00, 0xFF}, {0x00, 0x00, 0x00}, {0x00, 0x00, 0x00}}, // <------ colors
+                {0u}, // <------------------------ padding
+                70000ul, // <--------------------- actionDelayMicros
+                0u, // <-------------------------- syncRole (Off)
+                {'\0'} // <---------------------- syncLeaderId
             };
 
             void defaultSettings();
-            String hashNvSettings(struct NVSettings nvSet);
+            uint32 crcNvSettings(const struct NVSettings &nvSet, size_t length);
+            bool readNvSettings(const uint8 *stored);
+            bool loadVersion1Settings();
+            bool loadLegacySettings();
+            String hashLegacyNvSettings(const struct LegacyNVSettings &nvSet);
 
         public:
             Settings();
 
             bool loadSettings();
             bool saveSettings();
+            void requestSave();
+            bool service();
             bool factoryDefault();
 
             // Getters defined below
-            String           getActionName     ();
-            unsigned long    getActionDelay    ();
-            String           getColors         ();
+            unsigned char    getActionId       ();
+            unsigned long    getActionDelayMicros ();
+            uint32           getColor          (unsigned int index);
             unsigned int     getColorsSize     ();
+            unsigned int     getLedCount       ();
+            unsigned char    getDataPin        ();
+            unsigned char    getColorOrder     ();
+            unsigned char    getSyncRole       ();
+            const char*      getSyncLeaderId   ();
+            unsigned long    getSaveCount      ();
+            unsigned long    getSkippedSaveCount ();
 
             // Setters defined below
-            void     setActionName     (String actionName);
+            void     setActionId       (unsigned char actionId);
             void     setActionDelay    (unsigned long delayMillis);
-            void     setColors         (String colorsString);
+            void     setActionDelayMicros (unsigned long delayMicros);
+            void     setColor          (unsigned int index, uint32 rgb);
             void     setColorsSize     (unsigned int size);
+            void     setLedCount       (unsigned int ledCount);
+            void     setDataPin        (unsigned char dataPin);
+            void     setColorOrder     (unsigned char colorOrder);
+            void     setSyncRole       (unsigned char syncRole);
+            void     setSyncLeaderId   (const char *leaderId);
     };
 #endif
\ No newline at end of file
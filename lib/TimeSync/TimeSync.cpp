@@ -0,0 +1,150 @@
+/*
+  TimeSync - Keeps the clocks of several units in step so that their effects
+  line up. One unit leads and broadcasts a beacon holding its clock a few
+  times a second, the others follow by working out the offset between their
+  own clock and the leader's. A beacon is only ever late, never early, so a
+  beacon giving a larger offset than the estimate is taken straight away
+  while one giving a smaller offset only lowers the estimate by as much as
+  the clocks could have drifted apart since the last beacon. This only holds
+  the protocol, sending and receiving the beacons is left to the caller.
+*/
+
+#include <TimeSync.h>
+
+TimeSync::TimeSync() {
+    sampleCount = 0u;
+    nextSample = 0u;
+    offset = 0ll;
+    lastBeaconMicros = 0ull;
+    lastLeaderMicros = 0ull;
+    lastSequence = 0ul;
+    beaconCount = 0ul;
+    lostBeacons = 0ul;
+}
+
+/**
+ * Writes a beacon, all values are little endian:
+ *   magic (4), version (1), sequence (4), leader time in micros (8)
+ * 
+ * @param sequence - The number of the beacon, counting up from 1.
+ * @param leaderMicros - The leader's clock as it is sent.
+ * @param packet - Where to write the beacon, needs TIME_SYNC_BEACON_SIZE bytes.
+ * 
+ * @return Returns the size of the beacon as size_t.
+*/
+size_t TimeSync::writeBeacon(uint32_t sequence, uint64_t leaderMicros, uint8_t *packet) {
+    uint32_t magic = TIME_SYNC_MAGIC;
+    for (unsigned int i = 0u; i < 4u; i++) {
+        packet[i] = (uint8_t) (magic >> (i * 8u));
+        packet[5u + i] = (uint8_t) (sequence >> (i * 8u));
+    }
+    packet[4] = TIME_SYNC_VERSION;
+    for (unsigned int i = 0u; i < 8u; i++) {
+        packet[9u + i] = (uint8_t) (leaderMicros >> (i * 8u));
+    }
+
+    return TIME_SYNC_BEACON_SIZE;
+}
+
+/**
+ * Takes a beacon received from the leader into the offset estimate.
+ * 
+ * @param packet - The packet received.
+ * @param length - The length of the packet.
+ * @param localMicros - The local clock when the packet was received.
+ * 
+ * @return Returns true if the packet was a beacon otherwise false as bool.
+*/
+bool TimeSync::readBeacon(const uint8_t *packet, size_t length, uint64_t localMicros) {
+    if (length != TIME_SYNC_BEACON_SIZE || packet[4] != TIME_SYNC_VERSION) {
+        return false;
+    }
+    uint32_t magic = 0ul;
+    uint32_t sequence = 0ul;
+    uint64_t leaderMicros = 0ull;
+    for (unsigned int i = 0u; i < 4u; i++) {
+        magic |= (uint32_t) packet[i] << (i * 8u);
+        sequence |= (uint32_t) packet[5u + i] << (i * 8u);
+    }
+    for (unsigned int i = 0u; i < 8u; i++) {
+        leaderMicros |= (uint64_t) packet[9u + i] << (i * 8u);
+    }
+    if (magic != TIME_SYNC_MAGIC) {
+        return false;
+    }
+
+    int64_t sample = (int64_t) (leaderMicros - localMicros);
+    int64_t change = (sample > offset ? sample - offset : offset - sample);
+    if (sampleCount > 0u && change >= (int64_t) TIME_SYNC_TIMEOUT_MICROS) { // The leader restarted or changed
+        sampleCount = 0u;
+        nextSample = 0u;
+    } else if (sequence <= lastSequence) { // Arrived after a later beacon, it can only be the more delayed
+        return true;
+    } else if (lastSequence != 0ul) {
+        lostBeacons += sequence - lastSequence - 1ul;
+    }
+    lastSequence = sequence;
+    beaconCount++;
+
+    samples[nextSample] = sample;
+    nextSample = (nextSample + 1u) % TIME_SYNC_WINDOW;
+    if (sampleCount == 0u || sample > offset) {
+        offset = sample;
+    } else { // Let the offset fall only as fast as the clocks can drift apart
+        int64_t allowance = (int64_t) ((localMicros - lastBeaconMicros) / TIME_SYNC_DRIFT_DIVISOR);
+        offset = (offset - sample > allowance ? offset - allowance : sample);
+    }
+    if (sampleCount < TIME_SYNC_WINDOW) {
+        sampleCount++;
+    }
+    lastBeaconMicros = localMicros;
+
+    return true;
+}
+
+/**
+ * Tells whether a beacon has been heard from the leader recently.
+ * 
+ * @param localMicros - The local clock.
+ * 
+ * @return Returns true if the offset is current otherwise false as bool.
+*/
+bool TimeSync::isLocked(uint64_t localMicros) {
+    return sampleCount > 0u && localMicros - lastBeaconMicros < TIME_SYNC_TIMEOUT_MICROS;
+}
+
+/**
+ * Gives the leader's clock for the given local time. As the offset is
+ * refined the leader's clock may appear to step back a little, the time
+ * given out holds still rather than going back.
+ * 
+ * @param localMicros - The local clock.
+ * 
+ * @return Returns the leader's clock in micros as uint64_t.
+*/
+uint64_t TimeSync::toLeaderTime(uint64_t localMicros) {
+    uint64_t leaderMicros = localMicros + offset;
+    if (leaderMicros > lastLeaderMicros || lastLeaderMicros - leaderMicros > TIME_SYNC_TIMEOUT_MICROS) { // A large step back is a new leader
+        lastLeaderMicros = leaderMicros;
+    }
+
+    return lastLeaderMicros;
+}
+
+int64_t TimeSync::getOffsetMicros() { return offset; }
+unsigned long TimeSync::getBeaconCount() { return beaconCount; }
+unsigned long TimeSync::getLostBeacons() { return lostBeacons; }
+
+unsigned long TimeSync::getJitterMicros() {
+    if (sampleCount == 0u) {
+        return 0ul;
+    }
+    int64_t lowest = offset;
+    for (unsigned int i = 0u; i < sampleCount; i++) {
+        if (samples[i] < lowest) {
+            lowest = samples[i];
+        }
+    }
+
+    return (unsigned long) (offset - lowest);
+}
@@ -0,0 +1,65 @@
+/*
+  TimeSync - Keeps the clocks of several units in step so that their effects
+  line up. One unit leads and broadcasts a beacon holding its clock a few
+  times a second, the others follow by working out the offset between their
+  own clock and the leader's. A beacon is only ever late, never early, so a
+  beacon giving a larger offset than the estimate is taken straight away
+  while one giving a smaller offset only lowers the estimate by as much as
+  the clocks could have drifted apart since the last beacon. This only holds
+  the protocol, sending and receiving the beacons is left to the caller.
+*/
+
+#ifndef TimeSync_h
+    #define TimeSync_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #define TIME_SYNC_PORT 4050u
+    #define TIME_SYNC_MAGIC 0x434E5953ul // "SYNC"
+    #define TIME_SYNC_VERSION 1u
+    #define TIME_SYNC_BEACON_SIZE 17u
+    #define TIME_SYNC_INTERVAL_MICROS 250000ul
+    #define TIME_SYNC_WINDOW 8u // Beacons the jitter is measured over
+    #define TIME_SYNC_DRIFT_DIVISOR 20000u // Clocks are taken to drift apart by up to 1 part in this
+    #define TIME_SYNC_TIMEOUT_MICROS 3000000ul // No longer locked once beacons stop for this long
+
+    /*
+     * The part a unit plays in keeping time. These are persisted in
+     * the settings so must never be renumbered.
+     */
+    enum SyncRole : uint8_t {
+        SYNC_OFF = 0u,
+        SYNC_LEADER = 1u,
+        SYNC_FOLLOWER = 2u,
+        SYNC_ROLE_COUNT
+    };
+
+    class TimeSync {
+        private:
+            int64_t      samples     [TIME_SYNC_WINDOW]      ; // Leader minus local time of the recent beacons
+            unsigned int sampleCount                         ;
+            unsigned int nextSample                          ;
+            int64_t      offset                              ;
+            uint64_t     lastBeaconMicros                    ; // Local time
+            uint64_t     lastLeaderMicros                    ; // Last time given out, never goes back
+            uint32_t     lastSequence                        ;
+            unsigned long beaconCount                        ;
+            unsigned long lostBeacons                        ;
+
+        public:
+            TimeSync();
+
+            static size_t writeBeacon(uint32_t sequence, uint64_t leaderMicros, uint8_t *packet);
+            bool readBeacon(const uint8_t *packet, size_t length, uint64_t localMicros);
+
+            bool isLocked(uint64_t localMicros);
+            uint64_t toLeaderTime(uint64_t localMicros);
+
+            // Getters defined below
+            int64_t          getOffsetMicros     ();
+            unsigned long    getJitterMicros     ();
+            unsigned long    getBeaconCount      ();
+            unsigned long    getLostBeacons      ();
+    };
+#endif
@@ -0,0 +1,40 @@
+/*
+  Timebase - A microsecond clock which doesn't wrap. micros() wraps every
+  71 minutes and millis() every 49 days, which anything timed across the
+  wrap has to allow for. This extends micros() to 64 bits so that times can
+  simply be subtracted for as long as the device runs, provided now is
+  called at least once each time micros() wraps.
+*/
+
+#include <Timebase.h>
+
+Timebase::Timebase() {
+    lastMicros = 0ul;
+    wraps = 0ull;
+}
+
+/**
+ * Gives the time since boot.
+ * 
+ * @return Returns the time in micros as uint64_t.
+*/
+uint64_t Timebase::now() {
+    return extend(micros());
+}
+
+/**
+ * Extends the given reading of micros() to 64 bits. Readings
+ * must be given in order.
+ * 
+ * @param micros - The reading of micros().
+ * 
+ * @return Returns the time in micros as uint64_t.
+*/
+uint64_t Timebase::extend(uint32_t micros) {
+    if (micros < lastMicros) {
+        wraps += 0x100000000ull;
+    }
+    lastMicros = micros;
+
+    return wraps | micros;
+}
@@ -0,0 +1,25 @@
+/*
+  Timebase - A microsecond clock which doesn't wrap. micros() wraps every
+  71 minutes and millis() every 49 days, which anything timed across the
+  wrap has to allow for. This extends micros() to 64 bits so that times can
+  simply be subtracted for as long as the device runs, provided now is
+  called at least once each time micros() wraps.
+*/
+
+#ifndef Timebase_h
+    #define Timebase_h
+
+    #include <Arduino.h>
+
+    class Timebase {
+        private:
+            uint32_t     lastMicros      ;
+            uint64_t     wraps           ; // micros() wraps seen so far shifted into the high word
+
+        public:
+            Timebase();
+
+            uint64_t now();
+            uint64_t extend(uint32_t micros);
+    };
+#endif
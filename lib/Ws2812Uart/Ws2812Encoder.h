@@ -0,0 +1,53 @@
+/*
+  Ws2812Encoder - Encodes pixels into the byte stream which, when sent out of
+  an inverted UART running 6N1 at 3.2M baud, forms the WS2812 waveform. Each
+  UART frame is 8 bit times of 312.5ns (start, 6 data bits, stop) and carries
+  2 WS2812 bits, so every color byte becomes 4 UART bytes and every pixel 12.
+
+  This has no dependencies on the hardware so that it can be checked on its own.
+*/
+
+#ifndef Ws2812Encoder_h
+    #define Ws2812Encoder_h
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #define WS2812_UART_BYTES_PER_PIXEL 12u
+
+    namespace Ws2812Encoder {
+        /*
+         * The UART data bits for each pair of WS2812 bits, indexed by the pair's
+         * value. With the line inverted the start bit is sent high and the stop
+         * bit low, so 00 becomes high 1 bit time then low 3 twice over.
+         */
+        const uint8_t UART_DATA[4] = {0b110111, 0b000111, 0b110100, 0b000100};
+
+        inline void encodeByte(uint8_t value, uint8_t *out) {
+            out[0] = UART_DATA[(value >> 6) & 0x03];
+            out[1] = UART_DATA[(value >> 4) & 0x03];
+            out[2] = UART_DATA[(value >> 2) & 0x03];
+            out[3] = UART_DATA[value & 0x03];
+        }
+
+        /**
+         * Encodes the given pixels in the order their channels are sent to the strip.
+         * 
+         * @param pixels - The pixels as RGB byte triples.
+         * @param count - The number of pixels.
+         * @param channelOrder - The index into each triple of the 1st, 2nd and 3rd
+         * channel to send.
+         * @param out - Where to write the encoding, needs room for
+         * count * WS2812_UART_BYTES_PER_PIXEL bytes.
+         */
+        inline void encode(const uint8_t *pixels, size_t count, const uint8_t *channelOrder, uint8_t *out) {
+            for (size_t i = 0u; i < count; i++) {
+                encodeByte(pixels[channelOrder[0]], &out[0]);
+                encodeByte(pixels[channelOrder[1]], &out[4]);
+                encodeByte(pixels[channelOrder[2]], &out[8]);
+                pixels += 3;
+                out += WS2812_UART_BYTES_PER_PIXEL;
+            }
+        }
+    }
+#endif
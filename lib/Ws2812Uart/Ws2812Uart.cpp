@@ -0,0 +1,132 @@
+/*
+  Ws2812Uart - Drives a WS2812 strip from UART1, which on the ESP8266 is only
+  available on GPIO2. A frame is encoded into a waveform buffer up front and
+  then fed to the UART's 128 byte FIFO from its FIFO empty interrupt, so 
+  showing a frame returns as soon as it is encoded and interrupts are never
+  disabled while it is sent.
+*/
+
+#include <Ws2812Uart.h>
+
+Ws2812Uart::Ws2812Uart() {
+    buffer = nullptr;
+    bufferSize = 0u;
+    length = 0u;
+    position = 0u;
+    readyMicros = 0ul;
+}
+
+/**
+ * Allocates the waveform buffer and sets up UART1 to send it. This
+ * takes over the interrupt vector shared with UART0, see the header.
+ * 
+ * @param pixelCount - The number of pixels in the strip.
+ * 
+ * @return Returns true if the buffer could be allocated otherwise false as bool.
+*/
+bool Ws2812Uart::begin(size_t pixelCount) {
+    bufferSize = pixelCount * WS2812_UART_BYTES_PER_PIXEL;
+    buffer = new uint8_t[bufferSize];
+    if (buffer == nullptr) {
+        bufferSize = 0u;
+
+        return false;
+    }
+
+    Serial1.begin(WS2812_UART_BAUD, SERIAL_6N1, SERIAL_TX_ONLY);
+    USC0(UART1) |= (1 << UCTXI); // Idle low, start bits high
+
+    // Interrupt once the FIFO is down to a quarter full
+    USC1(UART1) = (USC1(UART1) & ~(0x7F << UCFET)) | ((WS2812_UART_FIFO_SIZE / 4u) << UCFET);
+    USIE(UART1) &= ~(1 << UIFE);
+    USIC(UART1) = (1 << UIFE);
+
+    // The vector is shared with UART0, whose handler this replaces
+    ETS_UART_INTR_DISABLE();
+    USIE(UART0) = 0;
+    USIC(UART0) = 0xFFFF;
+    ETS_UART_INTR_ATTACH(handleInterrupt, this);
+    ETS_UART_INTR_ENABLE();
+
+    return true;
+}
+
+/**
+ * Tells whether the previous frame is still being sent or the
+ * strip has yet to latch it.
+ * 
+ * @return Returns true if a new frame can't be shown yet as bool.
+*/
+bool Ws2812Uart::isBusy() {
+    return position < length || (long)(micros() - readyMicros) < 0l;
+}
+
+/**
+ * Encodes the given pixels and starts sending them, this returns
+ * without waiting for them to be sent.
+ * 
+ * @param pixels - The pixels as RGB byte triples.
+ * @param count - The number of pixels, more than the buffer holds are dropped.
+ * @param channelOrder - The index into each triple of the 1st, 2nd and 3rd
+ * channel to send.
+ * 
+ * @return Returns true if the frame was started or false if the previous one
+ * was still being sent as bool.
+*/
+bool Ws2812Uart::show(const uint8_t *pixels, size_t count, const uint8_t *channelOrder) {
+    if (isBusy()) {
+        return false;
+    }
+    if (count * WS2812_UART_BYTES_PER_PIXEL > bufferSize) {
+        count = bufferSize / WS2812_UART_BYTES_PER_PIXEL;
+    }
+
+    Ws2812Encoder::encode(pixels, count, channelOrder, buffer);
+
+    // Each UART frame takes 8 bit times of 312.5ns
+    size_t size = count * WS2812_UART_BYTES_PER_PIXEL;
+    readyMicros = micros() + ((size * 5u) / 2u) + WS2812_UART_LATCH_MICROS;
+
+    position = 0u;
+    length = size;
+    fillFifo();
+    if (position < length) {
+        USIC(UART1) = (1 << UIFE);
+        USIE(UART1) |= (1 << UIFE);
+    }
+
+    return true;
+}
+
+/*
+=================================================================
+Private Functions BELOW
+=================================================================
+*/
+
+/**
+ * #### PRIVATE ####
+ * Tops up the UART's FIFO from the waveform buffer.
+*/
+void IRAM_ATTR Ws2812Uart::fillFifo() {
+    size_t free = WS2812_UART_FIFO_SIZE - ((USS(UART1) >> USTXC) & 0xFF);
+    while (free-- > 0u && position < length) {
+        USF(UART1) = buffer[position++];
+    }
+}
+
+/**
+ * #### PRIVATE ####
+ * Handles the FIFO empty interrupt of UART1, the interrupt is turned
+ * off again once the whole buffer has been queued.
+*/
+void IRAM_ATTR Ws2812Uart::handleInterrupt(void *arg) {
+    Ws2812Uart *self = (Ws2812Uart *) arg;
+    if (USIS(UART1) & (1 << UIFE)) {
+        self->fillFifo();
+        if (self->position >= self->length) {
+            USIE(UART1) &= ~(1 << UIFE);
+        }
+    }
+    USIC(UART1) = USIS(UART1);
+}
@@ -0,0 +1,46 @@
+/*
+  Ws2812Uart - Drives a WS2812 strip from UART1, which on the ESP8266 is only
+  available on GPIO2. A frame is encoded into a waveform buffer up front and
+  then fed to the UART's 128 byte FIFO from its FIFO empty interrupt, so 
+  showing a frame returns as soon as it is encoded and interrupts are never
+  disabled while it is sent.
+
+  UART0 and UART1 share one interrupt vector, and begin() attaches its own
+  handler to it in place of the one the core installs for Serial. From then
+  on Serial can still send, but anything relying on its RX interrupt stops
+  working, so begin() masks UART0's interrupts rather than leave them firing
+  unhandled. Calling Serial.begin() afterwards takes the vector back and
+  stops the strip being fed.
+*/
+
+#ifndef Ws2812Uart_h
+    #define Ws2812Uart_h
+
+    #include <Arduino.h>
+    #include <esp8266_peri.h>
+    #include <Ws2812Encoder.h>
+
+    #define WS2812_UART_PIN 2u
+    #define WS2812_UART_BAUD 3200000ul
+    #define WS2812_UART_FIFO_SIZE 128u
+    #define WS2812_UART_LATCH_MICROS 300ul
+
+    class Ws2812Uart {
+        private:
+            uint8_t                     *buffer                  ;
+            size_t                      bufferSize               ;
+            volatile size_t             length                   ;
+            volatile size_t             position                 ;
+            unsigned long               readyMicros              ; // When the strip can take the next frame
+
+            static void IRAM_ATTR handleInterrupt(void *arg);
+            void IRAM_ATTR fillFifo();
+
+        public:
+            Ws2812Uart();
+
+            bool begin(size_t pixelCount);
+            bool isBusy();
+            bool show(const uint8_t *pixels, size_t count, const uint8_t *channelOrder);
+    };
+#endif
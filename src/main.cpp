@@ -21,30 +21,124 @@
 #include <ESP8266WiFi.h>
 #include <DNSServer.h>
 #include <ESP8266WebServer.h> 
-#include <map>
+#include <WebSocketsServer.h>
+#include <LittleFS.h>
 
 #include <Utils.h>
 #include <IpUtils.h>
 #include <Settings.h>
+#include <Scheduler.h>
+#include <PageWriter.h>
+#include <Histogram.h>
+#include <Timebase.h>
+#include <JsonReader.h>
+#include <DdpReceiver.h>
+#include <TimeSync.h>
+#include <Playlist.h>
 #include <HtmlContent.h>
+#include <WebAssets.h>
 #include <Lighting.h>
+#include <ControlForm.h>
+#include <StateApi.h>
 
 // Constants defined
-const unsigned int PRIORITY_REDUCER =  70u;
+const unsigned long FRAME_INTERVAL_MICROS = 4000ul;
+const unsigned long REALTIME_TIMEOUT_MILLIS = 2500ul; // Back to the effect once pixel data stops
+const size_t API_PLAYLIST_BODY_SIZE = 2048u; // Fits a full playlist written out in full
+const size_t API_PALETTE_BODY_SIZE = 3072u; // Fits a full palette of "#rrggbb" strings
+const size_t API_PATTERN_BODY_SIZE = 4096u; // Fits a full pattern with a line or space between instructions
 const IPAddress AP_IP(192, 168, 1, 1);
+const IPAddress FOLLOWER_AP_IP(192, 168, 2, 1); // Followers join the leader's network on AP_IP's subnet
 const IPAddress SUBNET(255, 255, 255, 0);
 
 // Define Services
 DNSServer dnsServer;
 ESP8266WebServer server(80);
+WebSocketsServer liveControl(81);
+DdpReceiver ddp;
+WiFiUDP syncUdp;
+TimeSync timeSync;
+Playlist playlist;
 Settings settings;
+Scheduler scheduler(FRAME_INTERVAL_MICROS);
+Timebase timebase;
+
+// Instrumentation
+Histogram loopTimes;
+Histogram httpTimes;
+Histogram realtimeLatency;
+Histogram pageTimes;
+Histogram captiveTimes;
+ulong captiveProbes = 0ul;
+ulong captiveRedirects = 0ul;
+ulong indexSent = 0ul;
+ulong indexNotModified = 0ul;
+ulong indexBytesSent = 0ul;
+
+/*
+ * The kinds of message taken over the live control WebSocket, each
+ * binary frame starts with one of these followed by its values:
+ *   LIVE_COLOR        index, red, green, blue
+ *   LIVE_DELAY        delay in micros as a 32 bit little endian value
+ *   LIVE_ACTION       effect ID
+ *   LIVE_COLORS_SIZE  number of colors in use
+ *   LIVE_COMMIT       nothing, saves the live state
+ */
+enum LiveMessage : uint8 {
+  LIVE_COLOR = 0x01u,
+  LIVE_DELAY = 0x02u,
+  LIVE_ACTION = 0x03u,
+  LIVE_COLORS_SIZE = 0x04u,
+  LIVE_COMMIT = 0x10u
+};
 
 // General Function prototypes
 void activateAPMode();
+void activateTimeSync();
 void handleRoot();
+void serveIndex();
+void handleFormPost();
+void handleGetPage();
+void handleMetrics();
+void handleGetState();
+void handlePatchState();
+void handleGetPlaylist();
+void handlePutPlaylist();
+bool readPlaylistEntry(JsonReader &reader, PlaylistEntry &entry);
+void handleGetPattern();
+void handlePutPattern();
+void handleGetPalette();
+void handlePutPalette();
+bool readPaletteColors(const char *json, bool save, uint &count, uint32 &crc);
+void handleLiveControl(uint8_t client, WStype_t type, uint8_t *payload, size_t length);
+void storeLiveState();
+void handleNotFound();
+bool isCaptiveProbe(const char *path);
+void timeHandler(void (*handler)(), Histogram *times = nullptr);
+void writeMetric(PageWriter &writer, const char *name, ulong value);
+void writeHistogram(PageWriter &writer, const char *name, Histogram &histogram);
+void renderLighting();
+void serviceNetwork();
+void serviceSettings();
+void serviceRestart();
+void serviceRealtime();
+void serviceTimeSync();
+void servicePlaylist();
+void servicePalette();
+uint64 lightingTime();
 
 String deviceId = "";
-int priorityCount = 0;
+String portalUrl = "";
+StripConfig strip;
+SyncConfig syncConfig;
+bool restartPending = false;
+ulong restartRequestedMillis = 0ul;
+ulong lastRealtimeMillis = 0ul;
+ulong realtimePushMicros = 0ul;
+bool realtimeShowPending = false;
+IPAddress syncBroadcastIp;
+uint32 beaconSequence = 0ul;
+ulong lastBeaconMillis = 0ul;
 
 /**
  * -----
@@ -60,21 +154,48 @@ void setup() {
 
   // Load intial settings from flash memory
   settings.loadSettings();
-  actionDelay = settings.getActionDelay();
-  currentAction = actions[settings.getActionName()];
-  actionColorsSize = settings.getColorsSize();
-  String colorsString = settings.getColors();
-  String colorsArray[MAX_COLORS] = {"000000"};
-  Utils::split(colorsString, ':', colorsArray, MAX_COLORS);
+  Palette palette;
+  palette.size = settings.getColorsSize();
   for (uint i = 0; i < MAX_COLORS; i++) {
-    actionColors[i] = rgbStringToColor(colorsArray[i], 0u);
+    palette.colors[i] = CRGB(settings.getColor(i));
   }
 
   // Initialize LEDs
-  initLighting();
+  strip = {settings.getLedCount(), settings.getDataPin(), settings.getColorOrder()};
+  validateStrip(strip);
+  initLighting(strip);
+  effectEngine.setStepMicros(settings.getActionDelayMicros());
+  effectEngine.setPalette(palette);
+  effectEngine.setEffect(isValidEffectId(settings.getActionId()) ? settings.getActionId() : EFFECT_FLASHING_COLORS);
+
+  // The playlist takes over from the saved state if it was playing, the
+  // custom pattern is there before it is first rendered
+  if (LittleFS.begin()) {
+    playlist.load(EFFECT_COUNT, MAX_STEP_MICROS);
+    patternVm.load();
+  }
+
+  // A follower without a leader to follow runs alone
+  syncConfig.role = settings.getSyncRole();
+  strncpy(syncConfig.leaderId, settings.getSyncLeaderId(), SYNC_LEADER_ID_SIZE);
+  if (syncConfig.role >= SYNC_ROLE_COUNT || (syncConfig.role == SYNC_FOLLOWER && syncConfig.leaderId[0] == '\0')) {
+    syncConfig.role = SYNC_OFF;
+  }
 
   // Activate AP
   activateAPMode();
+
+  // Lighting gets the frame deadlines and the network the time between them,
+  // long strips take longer to send than the usual frame interval allows.
+  scheduler.setFrameIntervalMicros(max(FRAME_INTERVAL_MICROS, stripFrameMicros(strip.ledCount)));
+  scheduler.setRenderTask(renderLighting);
+  scheduler.addBackgroundTask(serviceNetwork);
+  scheduler.addBackgroundTask(serviceSettings);
+  scheduler.addBackgroundTask(serviceRestart);
+  scheduler.addBackgroundTask(serviceRealtime);
+  scheduler.addBackgroundTask(servicePlaylist);
+  scheduler.addBackgroundTask(servicePalette);
+  activateTimeSync();
 }
 
 /**
@@ -83,11 +204,14 @@ void setup() {
  * the device.
  */
 void activateAPMode() {
+  bool follower = (syncConfig.role == SYNC_FOLLOWER);
+  IPAddress apIp = (follower ? FOLLOWER_AP_IP : AP_IP);
+
   WiFi.setSleepMode(WIFI_NONE_SLEEP);
   WiFi.setOutputPower(20.5F);
   WiFi.setHostname(deviceId.c_str());
-  WiFi.mode(WiFiMode::WIFI_AP);
-  WiFi.softAPConfig(AP_IP, AP_IP, SUBNET);
+  WiFi.mode(follower ? WiFiMode::WIFI_AP_STA : WiFiMode::WIFI_AP);
+  WiFi.softAPConfig(apIp, apIp, SUBNET);
 
   String ssid = "Strobbie_";
   ssid.concat(deviceId);
@@ -95,13 +219,58 @@ void activateAPMode() {
   
   WiFi.softAP(ssid, pwd);
 
+  // A follower also joins the leader's AP to hear its beacons
+  if (follower) {
+    String leaderSsid = "Strobbie_";
+    leaderSsid.concat(syncConfig.leaderId);
+    WiFi.begin(leaderSsid.c_str(), pwd.c_str());
+  }
+
   // Activate captive portal
-  dnsServer.start(53u, "*", AP_IP);
+  dnsServer.start(53u, "*", apIp);
+  portalUrl = "http://";
+  portalUrl.concat(apIp.toString());
+  portalUrl.concat('/');
 
   // Activate web server
-  server.on("/", handleRoot); 
-  server.onNotFound(handleRoot);
+  server.on("/", []() { timeHandler(handleRoot, &pageTimes); }); 
+  server.on("/metrics", []() { timeHandler(handleMetrics); });
+  server.on("/api/page", HTTP_GET, []() { timeHandler(handleGetPage); });
+  server.on("/api/state", HTTP_GET, []() { timeHandler(handleGetState); });
+  server.on("/api/state", HTTP_PATCH, []() { timeHandler(handlePatchState); });
+  server.on("/api/playlist", HTTP_GET, []() { timeHandler(handleGetPlaylist); });
+  server.on("/api/playlist", HTTP_PUT, []() { timeHandler(handlePutPlaylist); });
+  server.on("/api/pattern", HTTP_GET, []() { timeHandler(handleGetPattern); });
+  server.on("/api/pattern", HTTP_PUT, []() { timeHandler(handlePutPattern); });
+  server.on("/api/palette", HTTP_GET, []() { timeHandler(handleGetPalette); });
+  server.on("/api/palette", HTTP_PUT, []() { timeHandler(handlePutPalette); });
+  server.onNotFound([]() { timeHandler(handleNotFound, &captiveTimes); });
+  const char *headers[] = {"If-None-Match"};
+  server.collectHeaders(headers, 1u);
   server.begin();
+
+  // Activate live control
+  liveControl.onEvent(handleLiveControl);
+  liveControl.begin();
+
+  // Activate realtime pixel data
+  ddp.begin(DDP_PORT);
+}
+
+/**
+ * Starts keeping time with the other units when this unit leads
+ * or follows. Effects then run from the leader's clock rather than
+ * from when they were started, so every unit shows the same frame.
+ */
+void activateTimeSync() {
+  if (syncConfig.role == SYNC_OFF) {
+    return;
+  }
+
+  syncUdp.begin(TIME_SYNC_PORT);
+  syncBroadcastIp = IpUtils::deriveNetworkBroadcastAddress(AP_IP.toString(), SUBNET.toString());
+  effectEngine.setFreeRunning(true);
+  scheduler.addBackgroundTask(serviceTimeSync);
 }
 
 /**
@@ -115,161 +284,860 @@ void activateAPMode() {
  * post setup.
  */
 void loop() {
-  static ulong counter = 0;
-  if ((counter++) % PRIORITY_REDUCER == 0) { 
-    dnsServer.processNextRequest();
-    server.handleClient();
+  ulong start = micros();
+  scheduler.run();
+  loopTimes.record(micros() - start - scheduler.getLastSleepMicros()); // Only the time spent working
+}
+
+/**
+ * Render task of the scheduler, called once per frame.
+ */
+void renderLighting() {
+  if (effectEngine.service(lightingTime()) && realtimeShowPending && effectEngine.isExternal()) {
+    realtimeLatency.record(micros() - realtimePushMicros);
+    realtimeShowPending = false;
   }
-  
-  // Priority process
-  currentAction();
 }
 
 /**
- * Application web control page.
+ * Background task of the scheduler, services the captive
+ * portal and web server between frames.
+ */
+void serviceNetwork() {
+  dnsServer.processNextRequest();
+  server.handleClient();
+  liveControl.loop();
+}
+
+/**
+ * Background task of the scheduler, writes requested
+ * settings saves once they stop changing.
+ */
+void serviceSettings() {
+  settings.service();
+}
+
+/**
+ * Gives the time the lights run from, a follower runs from
+ * its estimate of the leader's clock.
  * 
+ * @return Returns the time in micros as uint64.
+ */
+uint64 lightingTime() {
+  uint64 now = timebase.now();
+
+  return (syncConfig.role == SYNC_FOLLOWER ? timeSync.toLeaderTime(now) : now);
+}
+
+/**
+ * Background task of the scheduler, the leader broadcasts
+ * its clock and followers take in what it broadcasts.
+ */
+void serviceTimeSync() {
+  if (syncConfig.role == SYNC_LEADER) {
+    if (millis() - lastBeaconMillis >= TIME_SYNC_INTERVAL_MICROS / 1000ul) {
+      lastBeaconMillis = millis();
+      uint8 beacon[TIME_SYNC_BEACON_SIZE];
+      size_t size = TimeSync::writeBeacon(++beaconSequence, timebase.now(), beacon);
+      syncUdp.beginPacket(syncBroadcastIp, TIME_SYNC_PORT);
+      syncUdp.write(beacon, size);
+      syncUdp.endPacket();
+    }
+  } else if (syncConfig.role == SYNC_FOLLOWER) {
+    int size = syncUdp.parsePacket();
+    if (size > 0) {
+      uint64 received = timebase.now();
+      uint8 beacon[TIME_SYNC_BEACON_SIZE];
+      syncUdp.read(beacon, sizeof(beacon));
+      timeSync.readBeacon(beacon, size, received);
+    }
+  }
+}
+
+/**
+ * Background task of the scheduler, reads realtime pixel data
+ * into the frame and hands the lights back to the effect once
+ * it stops coming. No packet is read while a pushed frame is
+ * waiting to be shown so that it can't be torn, the packets
+ * queue up meanwhile.
+ */
+void serviceRealtime() {
+  for (uint i = 0u; i < 4u && !effectEngine.isFramePending() && ddp.available(); i++) {
+    bool wasExternal = effectEngine.isExternal();
+    CRGB *frame = effectEngine.beginExternalFrame();
+    DdpResult result = ddp.read(frame[0].raw, effectEngine.getNumLeds() * sizeof(CRGB));
+    if (result == DDP_DATA || result == DDP_PUSH) {
+      lastRealtimeMillis = millis();
+    } else if (!wasExternal) {
+      effectEngine.endExternal();
+    }
+    if (result == DDP_PUSH) {
+      effectEngine.pushExternalFrame();
+      realtimePushMicros = micros();
+      realtimeShowPending = true;
+    }
+  }
+
+  if (effectEngine.isExternal() && millis() - lastRealtimeMillis >= REALTIME_TIMEOUT_MILLIS) {
+    effectEngine.endExternal();
+  }
+}
+
+/**
+ * Background task of the scheduler, moves the playlist on to
+ * its next entry when it is due, fading into it. Playlist
+ * changes aren't saved to the settings.
+ */
+void servicePlaylist() {
+  const PlaylistEntry *entry = playlist.service(millis());
+  if (entry == nullptr) {
+    return;
+  }
+
+  Palette palette;
+  palette.size = entry->colorsSize;
+  for (uint i = 0; i < MAX_COLORS; i++) {
+    palette.colors[i] = (i < entry->colorsSize ? CRGB(entry->colors[i][0], entry->colors[i][1], entry->colors[i][2]) : CRGB(CRGB::Black));
+  }
+  effectEngine.fadeNextChange(entry->fadeMillis * 1000ul);
+  effectEngine.setStepMicros(entry->stepMicros);
+  effectEngine.setPalette(palette);
+  if (entry->effectId != effectEngine.getEffectId()) {
+    effectEngine.setEffect(entry->effectId);
+  }
+}
+
+/**
+ * Background task of the scheduler, restarts the device
+ * shortly after a change which needs a restart so that
+ * the page sent beforehand has time to reach the client.
+ */
+void serviceRestart() {
+  if (restartPending && millis() - restartRequestedMillis >= 1000ul) {
+    ESP.restart();
+  }
+}
+
+/**
+ * Application web control page. The page itself is static and is sent
+ * gzipped as it was built, filling itself in from /api/page. A post of
+ * its form is applied and redirected back to the page.
  */
 void handleRoot() {
-  static CRGB tempColors[MAX_COLORS] = {actionColors[0]};
-  static uint tempColorsSize = settings.getColorsSize();
-  static ulong tempDelay = settings.getActionDelay();
-  static String tempAction = settings.getActionName();
-
-  if (server.method() == HTTP_GET) {
-    for (uint i = 0; i < MAX_COLORS; i ++) {
-      tempColors[i] = actionColors[i];
+  if (server.method() == HTTP_POST) {
+    handleFormPost();
+  } else {
+    serveIndex();
+  }
+}
+
+/**
+ * Sends the control page, or just a 304 when the browser already has
+ * this build of it. The ETag is a hash of the page so it only changes
+ * when the firmware does, and no-cache makes browsers check it each time.
+ */
+void serveIndex() {
+  server.sendHeader("ETag", INDEX_HTML_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == INDEX_HTML_ETAG) {
+    server.send(304);
+    indexNotModified++;
+
+    return;
+  }
+
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, PSTR("text/html"), (PGM_P) INDEX_HTML_GZ, INDEX_HTML_GZ_SIZE);
+  indexSent++;
+  indexBytesSent += INDEX_HTML_GZ_SIZE;
+}
+
+/**
+ * Applies a post of the control page form and redirects back to the
+ * page. Nothing is changed unless everything posted is valid, otherwise
+ * the label of the first invalid field is passed on for the page to show.
+ */
+void handleFormPost() {
+  FormCommand command = {effectEngine.getEffectId(), effectEngine.getStepMicros(), {}, 0u, strip, syncConfig, nullptr};
+  Palette palette = effectEngine.getPalette();
+  for (uint i = 0; i < MAX_COLORS; i++) {
+    command.colors[i] = palette.colors[i];
+  }
+  command.colorsSize = palette.size;
+
+  if (!decodeForm(server, command)) {
+    char location[32] = "/?invalid=";
+    size_t length = strlen(location);
+    for (const char *c = command.invalidField; *c != '\0' && length < sizeof(location) - 1u; c++) {
+      location[length++] = (*c == ' ' ? '+' : *c);
+    }
+    location[length] = '\0';
+    server.sendHeader("Location", location);
+    server.send(303);
+
+    return;
+  }
+
+  for (uint i = 0; i < MAX_COLORS; i++) {
+    palette.colors[i] = command.colors[i];
+  }
+  palette.size = command.colorsSize;
+
+  // Save updated settings
+  settings.setActionDelayMicros(command.delay);
+  settings.setActionId(command.action);
+  for (uint i = 0; i < MAX_COLORS; i++) {
+    settings.setColor(i, colorToRgb(palette.colors[i]));
+  }
+  settings.setColorsSize(palette.size);
+
+  // The strip and sync can only be changed by restarting with them
+  if (command.strip.ledCount != strip.ledCount || command.strip.dataPin != strip.dataPin || command.strip.colorOrder != strip.colorOrder
+      || command.sync.role != syncConfig.role || strcmp(command.sync.leaderId, syncConfig.leaderId) != 0) {
+    settings.setLedCount(command.strip.ledCount);
+    settings.setDataPin(command.strip.dataPin);
+    settings.setColorOrder(command.strip.colorOrder);
+    settings.setSyncRole(command.sync.role);
+    settings.setSyncLeaderId(command.sync.leaderId);
+    settings.saveSettings();
+    restartPending = true;
+    restartRequestedMillis = millis();
+  } else {
+    settings.requestSave();
+  }
+
+  // Set all application states
+  effectEngine.setStepMicros(command.delay);
+  effectEngine.setPalette(palette);
+  effectEngine.setEffect(command.action);
+
+  server.sendHeader("Location", "/");
+  server.send(303);
+}
+
+/**
+ * Serves what the control page shows as JSON, for example:
+ * {"version":"2.0.0","deviceId":"A1B2C3","action":2,"actions":["Solid Color",...],
+ * "delayMicros":70000,"colors":["#0000ff"],"maxColors":3,"ledCount":11,"maxLeds":600,
+ * "dataPin":5,"dataPins":[2,4,5,12,13,14],"colorOrder":2,"colorOrders":["RGB",...],
+ * "syncRole":0,"syncLeader":"","syncStatus":"","restarting":false,"frames":1234,
+ * "missedDeadlines":0,"showMicros":330}
+ * While a restart is pending the strip and sync settings it will apply are shown.
+ */
+void handleGetPage() {
+  StripConfig shownStrip = strip;
+  SyncConfig shownSync = syncConfig;
+  if (restartPending) {
+    shownStrip = {settings.getLedCount(), settings.getDataPin(), settings.getColorOrder()};
+    shownSync.role = settings.getSyncRole();
+    strncpy(shownSync.leaderId, settings.getSyncLeaderId(), SYNC_LEADER_ID_SIZE);
+    shownSync.leaderId[SYNC_LEADER_ID_SIZE - 1u] = '\0';
+  }
+  const Palette &palette = effectEngine.getPalette();
+
+  server.sendHeader("Cache-Control", "no-store");
+  PageWriter writer(server);
+  writer.begin(200, "application/json");
+  writer.write("{\"version\":\"" FIRMWARE_VERSION "\",\"deviceId\":\"");
+  writer.write(deviceId.c_str());
+  writer.write("\",\"action\":");
+  writer.write((ulong) effectEngine.getEffectId());
+  writer.write(",\"actions\":[");
+  for (uint id = 0u; id < EFFECT_COUNT; id++) {
+    writer.write(id == 0u ? "\"" : ",\"");
+    writer.write_P(EFFECT_DESCRIPTORS[id].label);
+    writer.write('"');
+  }
+  writer.write("],\"delayMicros\":");
+  writer.write(effectEngine.getStepMicros());
+  writer.write(",\"colors\":[");
+  for (uint i = 0u; i < palette.size; i++) {
+    char hex[7];
+    Utils::rgbDecimalsToHex(palette.colors[i].red, palette.colors[i].green, palette.colors[i].blue, hex);
+    writer.write(i == 0u ? "\"#" : ",\"#");
+    writer.write(hex);
+    writer.write('"');
+  }
+  writer.write("],\"maxColors\":");
+  writer.write((ulong) MAX_COLORS);
+  writer.write(",\"ledCount\":");
+  writer.write((ulong) shownStrip.ledCount);
+  writer.write(",\"maxLeds\":");
+  writer.write((ulong) MAX_LEDS);
+  writer.write(",\"dataPin\":");
+  writer.write((ulong) shownStrip.dataPin);
+  writer.write(",\"dataPins\":[");
+  for (uint i = 0u; i < DATA_PINS_COUNT; i++) {
+    if (i > 0u) {
+      writer.write(',');
+    }
+    writer.write((ulong) DATA_PINS[i]);
+  }
+  writer.write("],\"colorOrder\":");
+  writer.write((ulong) shownStrip.colorOrder);
+  writer.write(",\"colorOrders\":[");
+  for (uint order = 0u; order < COLOR_ORDER_COUNT; order++) {
+    writer.write(order == 0u ? "\"" : ",\"");
+    writer.write_P(COLOR_ORDER_NAMES[order]);
+    writer.write('"');
+  }
+  writer.write("],\"syncRole\":");
+  writer.write((ulong) shownSync.role);
+  writer.write(",\"syncLeader\":\"");
+  writer.write(shownSync.leaderId);
+  writer.write("\",\"syncStatus\":\"");
+  if (syncConfig.role == SYNC_LEADER) {
+    writer.write("Leading");
+  } else if (syncConfig.role == SYNC_FOLLOWER) {
+    if (timeSync.isLocked(timebase.now())) {
+      writer.write("Following, jitter ");
+      writer.write(timeSync.getJitterMicros());
+      writer.write(" us");
+    } else {
+      writer.write("Looking for the leader");
     }
-  } else if (server.method() == HTTP_POST) {
-    String formDo = server.arg("do");
-
-    // Handle various Form related 'DO' Actions...
-    if (String("add").equalsIgnoreCase(formDo)) { // <---------------------------- ADD Button
-      String colorHex[tempColorsSize];
-      for (uint i = 0; i < tempColorsSize; i++) {
-        String argName = "selectColor";
-        argName.concat(String(i));
-        colorHex[i] = server.arg(argName);
+  }
+  writer.write("\",\"restarting\":");
+  writer.write(restartPending ? "true" : "false");
+  writer.write(",\"frames\":");
+  writer.write(scheduler.getFrameCount());
+  writer.write(",\"missedDeadlines\":");
+  writer.write(scheduler.getMissedDeadlines());
+  writer.write(",\"showMicros\":");
+  writer.write(effectEngine.getShowMicros());
+  writer.write('}');
+  writer.end();
+}
+
+/**
+ * Serves the current state as JSON, see sendState().
+ */
+void handleGetState() {
+  sendState(server, strip);
+}
+
+/**
+ * Changes part of the state, see patchState(). A change is saved once
+ * changes stop coming.
+ */
+void handlePatchState() {
+  if (patchState(server, strip)) {
+    storeLiveState();
+    settings.requestSave();
+  }
+}
+
+/**
+ * Serves the playlist as JSON, for example:
+ * {"playing":true,"current":0,"entries":[{"action":3,"delayMicros":50000,"colors":["#ff0000"],"seconds":10,"fadeMillis":1000}]}
+ * It is streamed as it is written, a full playlist is too big for the stack.
+ */
+void handleGetPlaylist() {
+  PageWriter writer(server);
+  writer.begin(200, "application/json");
+  writer.write("{\"playing\":");
+  writer.write(playlist.isPlaying() ? "true" : "false");
+  writer.write(",\"current\":");
+  writer.write((ulong) playlist.getCurrent());
+  writer.write(",\"entries\":[");
+  for (uint i = 0u; i < playlist.getCount(); i++) {
+    const PlaylistEntry *entry = playlist.getEntry(i);
+    writer.write(i == 0u ? "{\"action\":" : ",{\"action\":");
+    writer.write((ulong) entry->effectId);
+    writer.write(",\"delayMicros\":");
+    writer.write((ulong) entry->stepMicros);
+    writer.write(",\"colors\":[");
+    for (uint c = 0u; c < entry->colorsSize; c++) {
+      char hex[7];
+      Utils::rgbDecimalToHex(((uint32) entry->colors[c][0] << 16) | ((uint32) entry->colors[c][1] << 8) | entry->colors[c][2], hex);
+      writer.write(c == 0u ? "\"#" : ",\"#");
+      writer.write(hex);
+      writer.write('"');
+    }
+    writer.write("],\"seconds\":");
+    writer.write((ulong) entry->seconds);
+    writer.write(",\"fadeMillis\":");
+    writer.write((ulong) entry->fadeMillis);
+    writer.write('}');
+  }
+  writer.write("]}");
+  writer.end();
+}
+
+/**
+ * Replaces the playlist from a JSON object holding "entries", an array
+ * of up to PLAYLIST_MAX_ENTRIES entries, and "playing". Each entry holds
+ * "action", "delayMicros", "colors" as for the state, "seconds" to show
+ * it for, at least 1, and "fadeMillis" to fade into it over. Either field
+ * can be left out to keep it as it is, setting "playing" starts the
+ * playlist from its first entry. The playlist is saved and sent back.
+ */
+void handlePutPlaylist() {
+  String body = server.arg("plain");
+  if (body.length() > API_PLAYLIST_BODY_SIZE) {
+    const char error[] = "{\"error\":\"Playlist too big\"}";
+    sendJson(server, 413, error, sizeof(error) - 1u);
+
+    return;
+  }
+
+  PlaylistEntry *entries = new PlaylistEntry[PLAYLIST_MAX_ENTRIES];
+  uint count = 0u;
+  bool hasEntries = false;
+  bool playing = playlist.isPlaying();
+  JsonReader reader(body.c_str());
+  char key[12];
+  bool ok = reader.beginObject();
+  while (ok && reader.nextKey(key, sizeof(key))) {
+    if (strcmp(key, "playing") == 0) {
+      ok = reader.readBool(playing);
+    } else if (strcmp(key, "entries") == 0) {
+      hasEntries = true;
+      ok = reader.beginArray();
+      while (ok && reader.nextItem()) {
+        ok = count < PLAYLIST_MAX_ENTRIES && readPlaylistEntry(reader, entries[count++]);
       }
-      for (uint i = 0; i < tempColorsSize; i++) {
-        if (!colorHex[i].isEmpty()) {
-          tempColors[i] = rgbStringToColor(colorHex[i], 1u);
+      ok = ok && !reader.hasFailed();
+    } else { // Unknown key
+      ok = false;
+    }
+  }
+  if (!ok || !reader.end()) {
+    delete[] entries;
+    const char error[] = "{\"error\":\"Invalid playlist\"}";
+    sendJson(server, 400, error, sizeof(error) - 1u);
+
+    return;
+  }
+
+  if (hasEntries) {
+    playlist.setEntries(entries, count);
+  }
+  delete[] entries;
+  if (playing) {
+    playlist.play();
+  } else {
+    playlist.stop();
+  }
+  playlist.save();
+
+  handleGetPlaylist();
+}
+
+/**
+ * Reads one entry of a playlist, all of its fields must be given.
+ * 
+ * @param reader - The JsonReader to read the entry from.
+ * @param entry - Where to put the entry.
+ * 
+ * @return Returns true if a valid entry was read otherwise false as bool.
+ */
+bool readPlaylistEntry(JsonReader &reader, PlaylistEntry &entry) {
+  memset(&entry, 0, sizeof(entry));
+  uint found = 0u;
+  char key[12];
+  bool ok = reader.beginObject();
+  while (ok && reader.nextKey(key, sizeof(key))) {
+    ulong value = 0ul;
+    if (strcmp(key, "action") == 0) {
+      ok = reader.readUnsigned(value) && isValidEffectId(value);
+      entry.effectId = value;
+      found |= 0x01u;
+    } else if (strcmp(key, "delayMicros") == 0) {
+      ok = reader.readUnsigned(value) && value <= MAX_STEP_MICROS;
+      entry.stepMicros = value;
+      found |= 0x02u;
+    } else if (strcmp(key, "colors") == 0) {
+      ok = reader.beginArray();
+      while (ok && reader.nextItem()) {
+        CRGB color;
+        ok = entry.colorsSize < PLAYLIST_MAX_COLORS && readApiColor(reader, color);
+        if (ok) {
+          entry.colors[entry.colorsSize][0] = color.red;
+          entry.colors[entry.colorsSize][1] = color.green;
+          entry.colors[entry.colorsSize][2] = color.blue;
+          entry.colorsSize++;
         }
       }
-      if (tempColorsSize < MAX_COLORS) {
-        tempColorsSize ++;
-        tempColors[tempColorsSize - 1] = CRGB::Black;
+      ok = ok && !reader.hasFailed() && entry.colorsSize > 0u;
+      found |= 0x04u;
+    } else if (strcmp(key, "seconds") == 0) {
+      ok = reader.readUnsigned(value) && value >= 1ul && value <= 0xFFFFul;
+      entry.seconds = value;
+      found |= 0x08u;
+    } else if (strcmp(key, "fadeMillis") == 0) {
+      ok = reader.readUnsigned(value) && value <= 0xFFFFul;
+      entry.fadeMillis = value;
+      found |= 0x10u;
+    } else { // Unknown key
+      ok = false;
+    }
+  }
+
+  return ok && !reader.hasFailed() && found == 0x1Fu;
+}
+
+/**
+ * Serves the custom pattern as hex, one instruction of
+ * PATTERN_INSTRUCTION_SIZE bytes per line.
+ */
+void handleGetPattern() {
+  const uint8 *program = patternVm.getProgram();
+  PageWriter writer(server);
+  writer.begin(200, "text/plain");
+  for (uint pc = 0u; pc < patternVm.getLength(); pc++) {
+    char hex[(PATTERN_INSTRUCTION_SIZE * 2u) + 2u];
+    for (uint i = 0u; i < PATTERN_INSTRUCTION_SIZE; i++) {
+      Utils::decimalTo8BitHex(program[(pc * PATTERN_INSTRUCTION_SIZE) + i], &hex[i * 2u]);
+    }
+    hex[PATTERN_INSTRUCTION_SIZE * 2u] = '\n';
+    hex[(PATTERN_INSTRUCTION_SIZE * 2u) + 1u] = '\0';
+    writer.write(hex);
+  }
+  writer.end();
+}
+
+/**
+ * Replaces the custom pattern with the program given as hex in the
+ * body, whitespace may come between bytes. The program is checked
+ * before it is taken, see PatternVm, then saved and sent back.
+ */
+void handlePutPattern() {
+  String body = server.arg("plain");
+  if (body.length() > API_PATTERN_BODY_SIZE) {
+    server.send(413, "text/plain", "Pattern too big\n");
+
+    return;
+  }
+
+  uint8 *program = new uint8[PATTERN_MAX_INSTRUCTIONS * PATTERN_INSTRUCTION_SIZE];
+  size_t size = 0u;
+  const char *hex = body.c_str();
+  bool ok = true;
+  while (ok && *hex != '\0') {
+    if (*hex == ' ' || *hex == '\t' || *hex == '\r' || *hex == '\n') {
+      hex++;
+    } else {
+      ok = size < PATTERN_MAX_INSTRUCTIONS * PATTERN_INSTRUCTION_SIZE && Utils::hexTo8BitDecimal(hex, program[size++]);
+      hex += 2;
+    }
+  }
+  ok = ok && size % PATTERN_INSTRUCTION_SIZE == 0u && patternVm.setProgram(program, size / PATTERN_INSTRUCTION_SIZE);
+  delete[] program;
+  if (!ok) {
+    server.send(400, "text/plain", "Invalid pattern\n");
+
+    return;
+  }
+  patternVm.save();
+  effectEngine.refresh();
+
+  handleGetPattern();
+}
+
+/**
+ * Serves the large palette as JSON, for example:
+ * {"colors":["#ff0000","#00ff00","#0000ff"]}
+ * The colors are read from flash a chunk at a time and streamed as
+ * they are written.
+ */
+void handleGetPalette() {
+  static uint8 colors[GRADIENT_PALETTE_CHUNK_COLORS * 3u];
+
+  PageWriter writer(server);
+  writer.begin(200, "application/json");
+  writer.write("{\"colors\":[");
+  bool first = true;
+  if (gradientPalette.openColors() > 0u) {
+    uint count;
+    while ((count = gradientPalette.readColors(colors, GRADIENT_PALETTE_CHUNK_COLORS)) > 0u) {
+      for (uint i = 0u; i < count; i++) {
+        char hex[7];
+        Utils::rgbDecimalsToHex(colors[i * 3u], colors[(i * 3u) + 1u], colors[(i * 3u) + 2u], hex);
+        writer.write(first ? "\"#" : ",\"#");
+        writer.write(hex);
+        writer.write('"');
+        first = false;
       }
-      tempDelay = (ulong)server.arg("changeDelay").toDouble();
-      tempAction = server.arg("action");
-    } else if (formDo.startsWith("remove")) { // <-------------------------- REMOVE Button
-      String colorNum = formDo.substring(7, 8);
-      String colorHex[tempColorsSize];
-      for (uint i = 0; i < tempColorsSize; i++) {
-        String argName = "selectColor";
-        argName.concat(String(i));
-        colorHex[i] = server.arg(argName);
+    }
+    gradientPalette.closeColors();
+  }
+  writer.write("]}");
+  writer.end();
+}
+
+/**
+ * Replaces the large palette from a JSON object holding "colors", an
+ * array of up to GRADIENT_PALETTE_MAX_COLORS "#rrggbb" strings, an
+ * empty array removes the palette. The body is read twice, once to
+ * check it and work out the CRC of the colors and once to write them
+ * out, so no colors are held. The palette is sent back and its gradient
+ * is worked out afresh between frames by servicePalette().
+ */
+void handlePutPalette() {
+  const String &body = server.arg("plain");
+  if (body.length() > API_PALETTE_BODY_SIZE) {
+    const char error[] = "{\"error\":\"Palette too big\"}";
+    sendJson(server, 413, error, sizeof(error) - 1u);
+
+    return;
+  }
+
+  uint count = 0u;
+  uint32 crc = 0ul;
+  bool ok = readPaletteColors(body.c_str(), false, count, crc);
+  if (ok) {
+    uint saved = 0u;
+    uint32 savedCrc = 0ul;
+    ok = gradientPalette.beginSave(count, crc);
+    ok = ok && readPaletteColors(body.c_str(), true, saved, savedCrc);
+    ok = gradientPalette.endSave() && ok;
+  }
+  if (!ok) {
+    const char error[] = "{\"error\":\"Invalid palette\"}";
+    sendJson(server, 400, error, sizeof(error) - 1u);
+
+    return;
+  }
+
+  handleGetPalette();
+}
+
+/**
+ * Reads the colors of a large palette from a JSON object holding
+ * "colors", each color is packed as it is read.
+ * 
+ * @param json - The JSON to read.
+ * @param save - Whether to hand each color to gradientPalette.saveColor().
+ * @param count - Where to count the colors.
+ * @param crc - Where to work out the CRC32 of the colors.
+ * 
+ * @return Returns true if the JSON was valid otherwise false as bool.
+ */
+bool readPaletteColors(const char *json, bool save, uint &count, uint32 &crc) {
+  JsonReader reader(json);
+  char key[8];
+  bool ok = reader.beginObject() && reader.nextKey(key, sizeof(key)) && strcmp(key, "colors") == 0 && reader.beginArray();
+  while (ok && reader.nextItem()) {
+    CRGB color;
+    ok = count < GRADIENT_PALETTE_MAX_COLORS && readApiColor(reader, color);
+    if (ok) {
+      crc = Utils::crc32(color.raw, 3u, crc);
+      count++;
+      ok = !save || gradientPalette.saveColor(color.raw);
+    }
+  }
+
+  return ok && !reader.hasFailed() && !reader.nextKey(key, sizeof(key)) && reader.end();
+}
+
+/**
+ * Background task of the scheduler, works out the gradient of the
+ * large palette once it is drawn from or whenever it is replaced,
+ * and hands it to the effect engine for the next frame. Doing this
+ * between frames keeps flash reads out of rendering.
+ */
+void servicePalette() {
+  if (gradientPalette.service(effectEngine.getEffectId() == EFFECT_PALETTE_GRADIENT)) {
+    effectEngine.setGradient(gradientPalette.getGradient());
+  }
+}
+
+/**
+ * Handles the live control WebSocket. Changes are applied from the next
+ * frame but aren't saved until a LIVE_COMMIT message, so they can be
+ * made as quickly as the client likes without writing flash. Malformed
+ * messages are ignored.
+ * 
+ * @param client - The number of the client which sent the message.
+ * @param type - The type of WebSocket event.
+ * @param payload - The message.
+ * @param length - The length of the message.
+ */
+void handleLiveControl(uint8_t client, WStype_t type, uint8_t *payload, size_t length) {
+  if (type != WStype_BIN || length == 0u) {
+    return;
+  }
+
+  switch (payload[0]) {
+    case LIVE_COLOR:
+      if (length == 5u && payload[1] < MAX_COLORS) {
+        Palette palette = effectEngine.getPalette();
+        palette.colors[payload[1]] = CRGB(payload[2], payload[3], payload[4]);
+        effectEngine.setPalette(palette);
       }
-      for (uint i = 0; i < tempColorsSize; i++) {
-        if (!colorHex[i].isEmpty()) {
-          tempColors[i] = rgbStringToColor(colorHex[i], 1);
+      break;
+    case LIVE_DELAY:
+      if (length == 5u) {
+        ulong delay = (ulong) payload[1] | ((ulong) payload[2] << 8) | ((ulong) payload[3] << 16) | ((ulong) payload[4] << 24);
+        if (delay <= MAX_STEP_MICROS) {
+          effectEngine.setStepMicros(delay);
         }
       }
-
-      uint iColorNum = colorNum.toInt();
-      if (iColorNum > 0u && iColorNum < tempColorsSize) {
-        for (uint i = iColorNum; i < tempColorsSize; i++) {
-          tempColors[i] = tempColors[i + 1];
-        }
-        tempColorsSize --;
+      break;
+    case LIVE_ACTION:
+      if (length == 2u && isValidEffectId(payload[1]) && payload[1] != effectEngine.getEffectId()) {
+        effectEngine.setEffect(payload[1]);
       }
-      tempDelay = (ulong)server.arg("changeDelay").toDouble();
-      tempAction = server.arg("action");
-    } else if (String("update").equalsIgnoreCase(formDo)) { // <--------------------- UPDATE Button
-      // Handle 'Update' Button click
-      String action = server.arg("action");
-      String delay = server.arg("changeDelay");
-      String colorHex[tempColorsSize];
-      String colorsString = "";
-
-      // Get color settings
-      for (uint i = 0; i < tempColorsSize; i++) {
-        String argName = "selectColor";
-        argName.concat(String(i));
-        colorHex[i] = server.arg(argName);
-        if (colorsString.isEmpty()) {
-          colorsString.concat(colorHex[i].substring(1));
-        } else {
-          colorsString.concat(":");
-          colorsString.concat(colorHex[i].substring(1));
-        }
+      break;
+    case LIVE_COLORS_SIZE:
+      if (length == 2u && payload[1] >= 1u && payload[1] <= MAX_COLORS) {
+        Palette palette = effectEngine.getPalette();
+        palette.size = payload[1];
+        effectEngine.setPalette(palette);
       }
-
-      // Save updated settings
-      settings.setActionDelay((unsigned long) delay.toDouble());
-      settings.setActionName(action);
-      settings.setColors(colorsString);
-      settings.setColorsSize(tempColorsSize);
-      settings.saveSettings();
-
-      // TODO: Verify incoming data!!!
-      
-      // Set all application states
-      tempAction = action;
-      currentAction = actions[action];
-      actionDelay = (unsigned long) delay.toDouble();
-      tempDelay = actionDelay;
-      for (uint i = 0; i < tempColorsSize; i++) {
-        if (!colorHex[i].isEmpty()) {
-          CRGB color = rgbStringToColor(colorHex[i], 1); 
-
-          actionColors[i] = color;
-          tempColors[i] = color;
-        }
+      break;
+    case LIVE_COMMIT:
+      if (length == 1u) {
+        storeLiveState();
+        settings.saveSettings();
       }
-      actionColorsSize = tempColorsSize;
+      break;
+  }
+}
+
+/**
+ * Copies the state the lights are running with into the settings,
+ * without saving them.
+ */
+void storeLiveState() {
+  const Palette &palette = effectEngine.getPalette();
+  settings.setActionId(effectEngine.getEffectId());
+  settings.setActionDelayMicros(effectEngine.getStepMicros());
+  for (uint i = 0; i < MAX_COLORS; i++) {
+    settings.setColor(i, colorToRgb(palette.colors[i]));
+  }
+  settings.setColorsSize(palette.size);
+}
+
+/**
+ * Answers requests for anything the web server doesn't have. Anything
+ * may come here as every name resolves to the device. Connectivity
+ * probes, which phones send over and over, get a small redirect to the
+ * control page which must not be cached so the portal is found each
+ * time. Anything else gets the same redirect but it may be cached for
+ * a minute. Neither builds the control page.
+ */
+void handleNotFound() {
+  bool probe = isCaptiveProbe(server.uri().c_str());
+  server.sendHeader("Location", portalUrl);
+  server.sendHeader("Cache-Control", probe ? "no-store" : "max-age=60");
+  server.send_P(302, PSTR("text/html"), HTML_PORTAL_REDIRECT);
+  if (probe) {
+    captiveProbes++;
+  } else {
+    captiveRedirects++;
+  }
+}
+
+/**
+ * Checks the given path against the known connectivity probes.
+ * 
+ * @param path - The path that was requested.
+ * 
+ * @return Returns true if it is a connectivity probe otherwise false as bool.
+ */
+bool isCaptiveProbe(const char *path) {
+  for (uint i = 0u; i < CAPTIVE_PROBE_PATHS_COUNT; i++) {
+    if (strcmp_P(path, CAPTIVE_PROBE_PATHS[i]) == 0) {
+      return true;
     }
   }
-  
-  // Set general page data
-  String pageTemplate = HTML_MAIN_PAGE_TEMPLATE;
-  pageTemplate.replace("${appVersion}", FIRMWARE_VERSION);
-
-  // Set the appropriate Action that is Selected
-  std::map<String, void (*)()>::iterator it = actions.begin();
-  while (it != actions.end()) {
-    String tempVar = "${"; 
-    tempVar.concat(it->first);
-    tempVar.concat("_sel}");
-    pageTemplate.replace(tempVar, (tempAction == it->first) ? "selected" : "");  
-    ++it;
+
+  return false;
+}
+
+/**
+ * Runs the given web handler and records how long it held up the loop.
+ * 
+ * @param handler - The handler to run.
+ * @param times - Where to also record the time, if anywhere.
+ */
+void timeHandler(void (*handler)(), Histogram *times) {
+  ulong start = micros();
+  handler();
+  ulong elapsed = micros() - start;
+  httpTimes.record(elapsed);
+  if (times != nullptr) {
+    times->record(elapsed);
   }
-  
-  // Set the action delay time
-  pageTemplate.replace("${changeDelay}", String(tempDelay));
-  
-  // Diable add button when max colors reached
-  pageTemplate.replace("${add_disable}", tempColorsSize == MAX_COLORS ? "disabled" : "");
-  pageTemplate.replace("${add_disableMessage}", tempColorsSize == MAX_COLORS ? "* Max colors reached." : "");
-
-  // Build out the Color Section of the page
-  String colorSection = "";
-  for (uint i = 0u; i < tempColorsSize; i++) {
-    String temp = HTML_COLOR_SELECTION_SECTION_TEMPLATE;
-    temp.replace("${colorNumber}", String(i));
-    temp.replace("${colorNumber}", String(i));
-    temp.replace("${colorNumber}", String(i));
-    temp.replace("${colorNumber}", String(i));
-    temp.replace("${colorNumber}", String(i));
-
-    // Diable removal of first color
-    temp.replace("${remove_disable}", i == 0 ? "disabled" : "");
-    
-    // Set the selected color
-    temp.replace("${selectColor}", Utils::rgbDecimalsToHex((uint8)tempColors[i].red, tempColors[i].green, tempColors[i].blue));
-    colorSection.concat(temp);
-  }
-  pageTemplate.replace("${selectedColors}", colorSection);
-
-  // Send the built page
-  server.send(200, "text/html", pageTemplate);
-}
\ No newline at end of file
+}
+
+/**
+ * Serves the counters and timings of the device as plain text, one
+ * metric per line. Timings are given as their count, mean and max
+ * followed by the bucket counts of their histogram.
+ */
+void handleMetrics() {
+  PageWriter writer(server);
+  writer.begin(200, "text/plain");
+  writeMetric(writer, "uptime_ms", millis());
+  writeMetric(writer, "frame_interval_us", scheduler.getFrameIntervalMicros());
+  writeMetric(writer, "frames", scheduler.getFrameCount());
+  writeMetric(writer, "missed_deadlines", scheduler.getMissedDeadlines());
+  writeMetric(writer, "skipped_frames", scheduler.getSkippedFrames());
+  writeMetric(writer, "max_lateness_us", scheduler.getMaxLatenessMicros());
+  writeMetric(writer, "idle_ms", scheduler.getIdleMillis());
+  writeMetric(writer, "idle_pct", millis() < 100ul ? 0ul : scheduler.getIdleMillis() / (millis() / 100ul));
+  writeMetric(writer, "frames_unchanged", effectEngine.getUnchangedFrames());
+  writeMetric(writer, "settings_saves", settings.getSaveCount());
+  writeMetric(writer, "settings_saves_skipped", settings.getSkippedSaveCount());
+  writeMetric(writer, "realtime_active", effectEngine.isExternal() ? 1ul : 0ul);
+  writeMetric(writer, "ddp_packets", ddp.getPacketCount());
+  writeMetric(writer, "ddp_frames", ddp.getFrameCount());
+  writeMetric(writer, "ddp_lost_packets", ddp.getLostPackets());
+  writeMetric(writer, "ddp_out_of_order_packets", ddp.getOutOfOrderPackets());
+  writeMetric(writer, "ddp_malformed_packets", ddp.getMalformedPackets());
+  writeMetric(writer, "captive_probes", captiveProbes);
+  writeMetric(writer, "captive_redirects", captiveRedirects);
+  writeMetric(writer, "index_sent", indexSent);
+  writeMetric(writer, "index_not_modified", indexNotModified);
+  writeMetric(writer, "index_bytes_sent", indexBytesSent);
+  writeMetric(writer, "pattern_instructions", patternVm.getLastInstructions());
+  writeMetric(writer, "pattern_over_budget_frames", patternVm.getOverBudgetFrames());
+  writeMetric(writer, "sync_role", syncConfig.role);
+  writeMetric(writer, "sync_locked", timeSync.isLocked(timebase.now()) ? 1ul : 0ul);
+  writeMetric(writer, "sync_beacons", syncConfig.role == SYNC_LEADER ? beaconSequence : timeSync.getBeaconCount());
+  writeMetric(writer, "sync_lost_beacons", timeSync.getLostBeacons());
+  writeMetric(writer, "sync_jitter_us", timeSync.getJitterMicros());
+  writeMetric(writer, "heap_free", ESP.getFreeHeap());
+  writeMetric(writer, "heap_max_block", ESP.getMaxFreeBlockSize());
+  writeMetric(writer, "heap_fragmentation_pct", ESP.getHeapFragmentation());
+
+  writer.write("# name count mean_us max_us then the counts below");
+  for (uint i = 0u; i < HISTOGRAM_BUCKETS - 1u; i++) {
+    writer.write(' ');
+    writer.write(Histogram::bucketLimit(i));
+  }
+  writer.write("us and the rest\n");
+  writeHistogram(writer, "loop", loopTimes);
+  writeHistogram(writer, "render", effectEngine.getRenderTimes());
+  writeHistogram(writer, "show", effectEngine.getShowTimes());
+  writeHistogram(writer, "http", httpTimes);
+  writeHistogram(writer, "page", pageTimes);
+  writeHistogram(writer, "captive", captiveTimes);
+  writeHistogram(writer, "realtime_latency", realtimeLatency);
+  writer.end();
+}
+
+void writeMetric(PageWriter &writer, const char *name, ulong value) {
+  writer.write(name);
+  writer.write(' ');
+  writer.write(value);
+  writer.write('\n');
+}
+
+void writeHistogram(PageWriter &writer, const char *name, Histogram &histogram) {
+  writer.write(name);
+  writer.write(' ');
+  writer.write(histogram.getCount());
+  writer.write(' ');
+  writer.write(histogram.getMeanMicros());
+  writer.write(' ');
+  writer.write(histogram.getMaxMicros());
+  for (uint i = 0u; i < HISTOGRAM_BUCKETS; i++) {
+    writer.write(' ');
+    writer.write(histogram.getBucket(i));
+  }
+  writer.write('\n');
+}
@@ -0,0 +1,59 @@
+/*
+  Arduino - Just enough of the ESP8266 Arduino core to build the libraries
+  on the host. The clock is a counter the tests move on by hand rather than
+  the real time, so anything timed runs the same on every run, and it wraps
+  at 32 bits as micros() does on the device. Part of the stand-ins used by
+  the native test environment, see test/README.
+*/
+
+#ifndef Arduino_h
+    #define Arduino_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdlib.h>
+    #include <string.h>
+    #include <stdio.h>
+    #include <math.h>
+    #include <algorithm>
+    #include <c_types.h>
+    #include <pgmspace.h>
+    #include <WString.h>
+
+    #define IRAM_ATTR
+    #define ICACHE_RAM_ATTR
+
+    typedef uint8_t byte;
+
+    using std::min;
+    using std::max;
+
+    namespace Native {
+        inline uint64_t clockMicros = 0ull;
+
+        inline void setMicros(uint64_t micros) { clockMicros = micros; }
+        inline void advanceMicros(uint64_t micros) { clockMicros += micros; }
+    }
+
+    inline unsigned long micros() { return (uint32_t) Native::clockMicros; }
+    inline unsigned long millis() { return (uint32_t) (Native::clockMicros / 1000ull); }
+    inline void delay(unsigned long ms) { Native::clockMicros += ms * 1000ull; }
+    inline void delayMicroseconds(unsigned int us) { Native::clockMicros += us; }
+    inline void yield() {}
+
+    #define SERIAL_8N1 0x1c
+    #define SERIAL_6N1 0x14
+    #define SERIAL_FULL 0
+    #define SERIAL_TX_ONLY 2
+
+    class HardwareSerial {
+        public:
+            void begin(unsigned long baud, int config = SERIAL_8N1, int mode = SERIAL_FULL) {}
+            size_t write(uint8_t c) { return 1u; }
+            void print(const char *text) {}
+            void println(const char *text = "") {}
+    };
+
+    inline HardwareSerial Serial;
+    inline HardwareSerial Serial1;
+#endif
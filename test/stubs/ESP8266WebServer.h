@@ -0,0 +1,90 @@
+/*
+  ESP8266WebServer - The request arguments and response calls the libraries
+  use. The arguments are whatever the test sets with nativeSetArgs() and the
+  response is collected so it can be checked. Part of the stand-ins used by
+  the native test environment, see test/README.
+*/
+
+#ifndef ESP8266WebServer_h
+    #define ESP8266WebServer_h
+
+    #include <string.h>
+    #include <string>
+    #include <utility>
+    #include <vector>
+    #include <Arduino.h>
+
+    #define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+
+    class ESP8266WebServer {
+        private:
+            std::vector<std::pair<String, String>>   arguments               ;
+            String                                   emptyArgument           ;
+
+        public:
+            int              responseCode        = 0     ;
+            size_t           contentLength       = 0u    ;
+            std::string      response                    ; // The body sent so far
+            unsigned long    chunkCount          = 0ul   ; // Calls to sendContent() with content
+
+            ESP8266WebServer(int port = 80) {}
+
+            int args() { return arguments.size(); }
+            const String &argName(int i) { return (i >= 0 && i < args() ? arguments[i].first : emptyArgument); }
+            const String &arg(int i) { return (i >= 0 && i < args() ? arguments[i].second : emptyArgument); }
+
+            const String &arg(const String &name) {
+                for (const auto &argument : arguments) {
+                    if (argument.first == name) {
+                        return argument.second;
+                    }
+                }
+
+                return emptyArgument;
+            }
+
+            bool hasArg(const String &name) {
+                for (const auto &argument : arguments) {
+                    if (argument.first == name) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void setContentLength(size_t length) { contentLength = length; }
+
+            void send(int code, const char *contentType = nullptr, const String &content = String()) {
+                responseCode = code;
+                response.assign(content.c_str(), content.length());
+            }
+
+            void sendContent(const char *content, size_t size) {
+                if (size > 0u) {
+                    response.append(content, size);
+                    chunkCount++;
+                }
+            }
+
+            void sendContent(const char *content) { sendContent(content, strlen(content)); }
+            void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+
+            /*
+             * Test hooks, not part of ESP8266WebServer.
+             */
+
+            // Replaces the arguments of the request being handled
+            void nativeSetArgs(const std::vector<std::pair<String, String>> &arguments) {
+                this->arguments = arguments;
+            }
+
+            // Forgets the response sent so far
+            void nativeReset() {
+                responseCode = 0;
+                contentLength = 0u;
+                response.clear();
+                chunkCount = 0ul;
+            }
+    };
+#endif
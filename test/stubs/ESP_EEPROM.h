@@ -0,0 +1,139 @@
+/*
+  ESP_EEPROM - An in-memory model of the ESP_EEPROM library. Like the real
+  one it keeps a 4KB flash sector which starts with the size of the record
+  and a bitmap of used slots, and writes each commit into the next free
+  slot, only erasing the sector once they have all been used. Stored data
+  only reads back when begin() is given the size it was stored with. Commits
+  and erases are counted so tests can see how often flash would be worn.
+  Part of the stand-ins used by the native test environment, see test/README.
+*/
+
+#ifndef ESP_EEPROM_h
+    #define ESP_EEPROM_h
+
+    #include <string.h>
+    #include <vector>
+    #include <Arduino.h>
+
+    #define EEPROM_SECTOR_SIZE 4096u
+    #define EEPROM_SECTOR_HEADER_SIZE 4u
+
+    class EEPROMClass {
+        private:
+            std::vector<uint8_t> buffer              ; // Between begin() and end()
+            std::vector<uint8_t> stored              ; // The record in the last used slot
+            size_t           size                = 0u    ;
+            size_t           storedSize          = 0u    ; // 0 while the sector is erased
+            unsigned int     usedSlots           = 0u    ;
+            bool             blank               = true  ; // Erased and yet to be written to
+            bool             dirty               = false ;
+            unsigned long    commits             = 0ul   ; // Slots written
+            unsigned long    erases              = 0ul   ; // Sectors erased
+
+        public:
+            /**
+             * The slots a record of the given size gets, each takes its
+             * size rounded up to a word plus a bit of the bitmap.
+             */
+            static unsigned int slotCount(size_t size) {
+                size_t slotSize = (size + 3u) & ~((size_t) 3u);
+
+                return ((EEPROM_SECTOR_SIZE - EEPROM_SECTOR_HEADER_SIZE) * 8u) / ((slotSize * 8u) + 1u);
+            }
+
+            void begin(size_t size) {
+                this->size = size;
+                buffer.assign(size, 0xFFu);
+                if (storedSize == size) {
+                    buffer = stored;
+                }
+                dirty = false;
+            }
+
+            int percentUsed() {
+                if (storedSize == 0u || storedSize != size) {
+                    return -1;
+                }
+
+                return (usedSlots * 100u) / slotCount(size);
+            }
+
+            template <typename T>
+            T &get(int address, T &t) {
+                if (address >= 0 && address + sizeof(T) <= buffer.size()) {
+                    memcpy(&t, &buffer[address], sizeof(T));
+                }
+
+                return t;
+            }
+
+            template <typename T>
+            const T &put(int address, const T &t) {
+                if (address >= 0 && address + sizeof(T) <= buffer.size()) {
+                    memcpy(&buffer[address], &t, sizeof(T));
+                    dirty = true;
+                }
+
+                return t;
+            }
+
+            bool commit() {
+                if (size == 0u) {
+                    return false;
+                }
+                if (!dirty) {
+                    return true;
+                }
+                if (blank || storedSize != size || usedSlots == slotCount(size)) {
+                    erases += (blank ? 0u : 1u);
+                    blank = false;
+                    usedSlots = 0u;
+                    storedSize = size;
+                }
+                stored = buffer;
+                usedSlots++;
+                commits++;
+                dirty = false;
+
+                return true;
+            }
+
+            bool wipe() {
+                erases++;
+                blank = true;
+                storedSize = 0u;
+                usedSlots = 0u;
+                stored.clear();
+
+                return true;
+            }
+
+            void end() {
+                buffer.clear();
+                size = 0u;
+            }
+
+            /*
+             * Test hooks, not part of ESP_EEPROM.
+             */
+
+            // Forgets everything, as a new device's erased flash
+            void nativeReset() {
+                *this = EEPROMClass();
+            }
+
+            // Leaves the given record in flash, as older firmware would have
+            void nativeStore(const void *data, size_t size) {
+                stored.assign((const uint8_t *) data, ((const uint8_t *) data) + size);
+                storedSize = size;
+                usedSlots = 1u;
+                blank = false;
+            }
+
+            const uint8_t *nativeStored() { return stored.data(); }
+            unsigned long nativeCommits() { return commits; }
+            unsigned long nativeErases() { return erases; }
+    };
+
+    inline EEPROMClass EEPROM;
+#endif
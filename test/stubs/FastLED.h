@@ -0,0 +1,113 @@
+/*
+  FastLED - The parts of FastLED the effects use. Colors and blending work
+  as they do in FastLED, while adding a strip only keeps its pixels and
+  showing them does nothing. Part of the stand-ins used by the native test
+  environment, see test/README.
+*/
+
+#ifndef FastLED_h
+    #define FastLED_h
+
+    #include <stdint.h>
+
+    typedef uint8_t fract8;
+
+    struct CRGB {
+        union {
+            struct {
+                union { uint8_t r; uint8_t red; };
+                union { uint8_t g; uint8_t green; };
+                union { uint8_t b; uint8_t blue; };
+            };
+            uint8_t raw[3];
+        };
+
+        enum HTMLColorCode : uint32_t {
+            Black = 0x000000,
+            Blue = 0x0000FF,
+            Green = 0x008000,
+            Red = 0xFF0000,
+            White = 0xFFFFFF
+        };
+
+        CRGB() {}
+        CRGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
+        CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+        CRGB(HTMLColorCode colorcode) : CRGB((uint32_t) colorcode) {}
+
+        bool operator==(const CRGB &other) const { return r == other.r && g == other.g && b == other.b; }
+        bool operator!=(const CRGB &other) const { return !(*this == other); }
+    };
+    static_assert(sizeof(CRGB) == 3u, "CRGB must be packed as three bytes of RGB");
+
+    // As FastLED's blend8, with FASTLED_BLEND_FIXED
+    inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+        uint16_t partial = (a << 8) | b;
+        partial += (b * amountOfB);
+        partial -= (a * amountOfB);
+
+        return partial >> 8;
+    }
+
+    inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2) {
+        return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+    }
+
+    inline CRGB *blend(const CRGB *src1, const CRGB *src2, CRGB *dest, uint16_t count, fract8 amountOfsrc2) {
+        for (uint16_t i = 0u; i < count; i++) {
+            dest[i] = blend(src1[i], src2[i], amountOfsrc2);
+        }
+
+        return dest;
+    }
+
+    enum EOrder {
+        RGB = 0012,
+        RBG = 0021,
+        GRB = 0102,
+        GBR = 0120,
+        BRG = 0201,
+        BGR = 0210
+    };
+
+    template <uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+    class WS2812B {};
+
+    class CLEDController {
+        private:
+            CRGB     *leds       = nullptr   ;
+            int      count       = 0         ;
+
+        public:
+            CLEDController &setLeds(CRGB *data, int nLeds) {
+                leds = data;
+                count = nLeds;
+
+                return *this;
+            }
+
+            CRGB *getLeds() { return leds; }
+            int size() { return count; }
+    };
+
+    class CFastLED {
+        private:
+            CLEDController   controller      ;
+
+        public:
+            template <template <uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+            CLEDController &addLeds(CRGB *data, int nLeds) {
+                return controller.setLeds(data, nLeds);
+            }
+
+            void show() {}
+
+            void clear(bool writeData = false) {
+                for (int i = 0; i < controller.size(); i++) {
+                    controller.getLeds()[i] = CRGB(0u, 0u, 0u);
+                }
+            }
+    };
+
+    inline CFastLED FastLED;
+#endif
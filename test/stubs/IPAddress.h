@@ -0,0 +1,32 @@
+/*
+  IPAddress - An IPv4 address. Part of the stand-ins used by the native test
+  environment, see test/README.
+*/
+
+#ifndef IPAddress_h
+    #define IPAddress_h
+
+    #include <stdio.h>
+    #include <string.h>
+    #include <WString.h>
+
+    class IPAddress {
+        private:
+            uint8_t      octets      [4]     ;
+
+        public:
+            IPAddress() : octets{0u, 0u, 0u, 0u} {}
+            IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+
+            uint8_t operator[](int index) const { return octets[index]; }
+            bool operator==(const IPAddress &other) const { return memcmp(octets, other.octets, 4u) == 0; }
+            bool operator!=(const IPAddress &other) const { return !(*this == other); }
+
+            String toString() const {
+                char text[16];
+                snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+
+                return String(text);
+            }
+    };
+#endif
@@ -0,0 +1,98 @@
+/*
+  LittleFS - An in-memory file system with the parts of the LittleFS API
+  the libraries use. Files last until the test calls LittleFS.format().
+  Part of the stand-ins used by the native test environment, see test/README.
+*/
+
+#ifndef LittleFS_h
+    #define LittleFS_h
+
+    #include <string.h>
+    #include <map>
+    #include <memory>
+    #include <string>
+    #include <vector>
+    #include <c_types.h>
+
+    class File {
+        private:
+            std::shared_ptr<std::vector<uint8_t>>    data        ;
+            size_t                                   position    = 0u    ;
+            bool                                     writable    = false ;
+
+        public:
+            File() {}
+            File(std::shared_ptr<std::vector<uint8_t>> data, bool writable) : data(data), writable(writable) {}
+
+            operator bool() const { return data != nullptr; }
+
+            size_t read(uint8_t *buffer, size_t size) {
+                if (!data || writable) {
+                    return 0u;
+                }
+                size_t count = (data->size() - position < size ? data->size() - position : size);
+                memcpy(buffer, data->data() + position, count);
+                position += count;
+
+                return count;
+            }
+
+            size_t write(const uint8_t *buffer, size_t size) {
+                if (!data || !writable) {
+                    return 0u;
+                }
+                data->insert(data->end(), buffer, buffer + size);
+
+                return size;
+            }
+
+            bool seek(uint32_t position) {
+                if (!data || position > data->size()) {
+                    return false;
+                }
+                this->position = position;
+
+                return true;
+            }
+
+            size_t size() const { return (data ? data->size() : 0u); }
+            int available() const { return (data && !writable ? (int) (data->size() - position) : 0); }
+
+            void close() {
+                data.reset();
+                position = 0u;
+            }
+    };
+
+    class FS {
+        private:
+            std::map<std::string, std::shared_ptr<std::vector<uint8_t>>>    files   ;
+
+        public:
+            bool begin() { return true; }
+            void end() {}
+
+            // Only the "r" and "w" modes are supported
+            File open(const char *path, const char *mode) {
+                if (mode[0] == 'w') {
+                    files[path] = std::make_shared<std::vector<uint8_t>>();
+
+                    return File(files[path], true);
+                }
+                auto found = files.find(path);
+
+                return (found != files.end() ? File(found->second, false) : File());
+            }
+
+            bool exists(const char *path) { return files.count(path) > 0u; }
+            bool remove(const char *path) { return files.erase(path) > 0u; }
+
+            bool format() {
+                files.clear();
+
+                return true;
+            }
+    };
+
+    inline FS LittleFS;
+#endif
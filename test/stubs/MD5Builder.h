@@ -0,0 +1,123 @@
+/*
+  MD5Builder - The ESP8266 core's MD5 helper, worked out in plain C++ so
+  that hashes match those made on the device. Part of the stand-ins used
+  by the native test environment, see test/README.
+*/
+
+#ifndef MD5Builder_h
+    #define MD5Builder_h
+
+    #include <string.h>
+    #include <Arduino.h>
+
+    class MD5Builder {
+        private:
+            uint32_t     state       [4]     ;
+            uint8_t      block       [64]    ;
+            uint64_t     length              ; // Bytes added so far
+            uint8_t      digest      [16]    ;
+
+            static uint32_t rotate(uint32_t value, unsigned int bits) {
+                return (value << bits) | (value >> (32u - bits));
+            }
+
+            void transform() {
+                static const uint32_t K[64] = {
+                    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+                    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+                    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+                    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+                    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+                    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+                    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+                    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+                };
+                static const uint8_t SHIFTS[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+                uint32_t words[16];
+                for (unsigned int i = 0u; i < 16u; i++) {
+                    words[i] = block[i * 4u] | (block[(i * 4u) + 1u] << 8) | (block[(i * 4u) + 2u] << 16) | ((uint32_t) block[(i * 4u) + 3u] << 24);
+                }
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                for (unsigned int i = 0u; i < 64u; i++) {
+                    uint32_t f;
+                    unsigned int g;
+                    if (i < 16u) {
+                        f = (b & c) | (~b & d);
+                        g = i;
+                    } else if (i < 32u) {
+                        f = (d & b) | (~d & c);
+                        g = ((5u * i) + 1u) % 16u;
+                    } else if (i < 48u) {
+                        f = b ^ c ^ d;
+                        g = ((3u * i) + 5u) % 16u;
+                    } else {
+                        f = c ^ (b | ~d);
+                        g = (7u * i) % 16u;
+                    }
+                    uint32_t next = d;
+                    d = c;
+                    c = b;
+                    b = b + rotate(a + f + K[i] + words[g], SHIFTS[((i / 16u) * 4u) + (i % 4u)]);
+                    a = next;
+                }
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+            }
+
+        public:
+            void begin() {
+                state[0] = 0x67452301;
+                state[1] = 0xefcdab89;
+                state[2] = 0x98badcfe;
+                state[3] = 0x10325476;
+                length = 0u;
+            }
+
+            void add(const uint8_t *data, uint16_t size) {
+                while (size-- > 0u) {
+                    block[length++ % 64u] = *data++;
+                    if (length % 64u == 0u) {
+                        transform();
+                    }
+                }
+            }
+
+            void add(const char *data) { add((const uint8_t *) data, strlen(data)); }
+            void add(const String &data) { add((const uint8_t *) data.c_str(), data.length()); }
+
+            void calculate() {
+                uint64_t bits = length * 8u;
+                uint8_t pad = 0x80u;
+                add(&pad, 1u);
+                pad = 0x00u;
+                while (length % 64u != 56u) {
+                    add(&pad, 1u);
+                }
+                uint8_t size[8];
+                for (unsigned int i = 0u; i < 8u; i++) {
+                    size[i] = (uint8_t) (bits >> (i * 8u));
+                }
+                add(size, 8u);
+                for (unsigned int i = 0u; i < 16u; i++) {
+                    digest[i] = (uint8_t) (state[i / 4u] >> ((i % 4u) * 8u));
+                }
+            }
+
+            void getBytes(uint8_t *output) { memcpy(output, digest, sizeof(digest)); }
+
+            String toString() {
+                static const char HEX_DIGITS[] = "0123456789abcdef";
+                char hex[33];
+                for (unsigned int i = 0u; i < 16u; i++) {
+                    hex[i * 2u] = HEX_DIGITS[digest[i] >> 4];
+                    hex[(i * 2u) + 1u] = HEX_DIGITS[digest[i] & 0x0Fu];
+                }
+                hex[32] = '\0';
+
+                return String(hex);
+            }
+    };
+#endif
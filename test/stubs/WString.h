@@ -0,0 +1,79 @@
+/*
+  WString - The Arduino String on top of std::string, with just what the
+  libraries use. Part of the stand-ins used by the native test environment,
+  see test/README.
+*/
+
+#ifndef WString_h
+    #define WString_h
+
+    #include <stdlib.h>
+    #include <ctype.h>
+    #include <string>
+    #include <c_types.h>
+
+    class String {
+        private:
+            std::string      value       ;
+
+        public:
+            String(const char *text = "") : value(text != nullptr ? text : "") {}
+            String(const std::string &text) : value(text) {}
+            explicit String(char c) : value(1u, c) {}
+            explicit String(int number) : value(std::to_string(number)) {}
+            explicit String(unsigned int number) : value(std::to_string(number)) {}
+            explicit String(long number) : value(std::to_string(number)) {}
+            explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+            unsigned int length() const { return value.length(); }
+            const char *c_str() const { return value.c_str(); }
+            char charAt(unsigned int index) const { return (index < value.length() ? value[index] : '\0'); }
+            char operator[](unsigned int index) const { return charAt(index); }
+            long toInt() const { return atol(value.c_str()); }
+            bool reserve(unsigned int size) { value.reserve(size); return true; }
+
+            bool concat(const String &text) { value += text.value; return true; }
+            bool concat(const char *text) { value += text; return true; }
+            bool concat(char c) { value += c; return true; }
+            String &operator+=(const String &text) { concat(text); return *this; }
+            String &operator+=(const char *text) { concat(text); return *this; }
+            String &operator+=(char c) { concat(c); return *this; }
+
+            String substring(unsigned int from) const { return substring(from, value.length()); }
+            String substring(unsigned int from, unsigned int to) const {
+                if (from > to) {
+                    unsigned int swap = from;
+                    from = to;
+                    to = swap;
+                }
+                if (from >= value.length()) {
+                    return String();
+                }
+
+                return String(value.substr(from, to - from));
+            }
+
+            void toUpperCase() {
+                for (char &c : value) {
+                    c = toupper((unsigned char) c);
+                }
+            }
+
+            void toLowerCase() {
+                for (char &c : value) {
+                    c = tolower((unsigned char) c);
+                }
+            }
+
+            bool startsWith(const String &prefix) const { return value.compare(0u, prefix.value.length(), prefix.value) == 0; }
+            bool equals(const String &other) const { return value == other.value; }
+            bool operator==(const String &other) const { return value == other.value; }
+            bool operator==(const char *other) const { return value == other; }
+            bool operator!=(const String &other) const { return value != other.value; }
+            bool operator!=(const char *other) const { return value != other; }
+            bool operator<(const String &other) const { return value < other.value; }
+
+            friend String operator+(const String &left, const String &right) { return String(left.value + right.value); }
+            friend String operator+(const String &left, const char *right) { return String(left.value + right); }
+    };
+#endif
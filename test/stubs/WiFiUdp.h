@@ -0,0 +1,75 @@
+/*
+  WiFiUdp - A UDP socket which receives the packets a test queues up with
+  WiFiUDP::nativeQueue() and keeps the last packet sent. Part of the
+  stand-ins used by the native test environment, see test/README.
+*/
+
+#ifndef WiFiUdp_h
+    #define WiFiUdp_h
+
+    #include <string.h>
+    #include <deque>
+    #include <vector>
+    #include <IPAddress.h>
+
+    class WiFiUDP {
+        private:
+            std::vector<uint8_t>     packet                  ; // Being read
+            size_t                   position        = 0u    ;
+            std::vector<uint8_t>     sending                 ;
+
+        public:
+            inline static std::deque<std::vector<uint8_t>>   received    ;
+            inline static std::vector<uint8_t>               lastSent    ;
+
+            uint8_t begin(uint16_t port) { return 1u; }
+            void stop() {}
+
+            int parsePacket() {
+                packet.clear();
+                position = 0u;
+                if (received.empty()) {
+                    return 0;
+                }
+                packet = received.front();
+                received.pop_front();
+
+                return packet.size();
+            }
+
+            int available() { return packet.size() - position; }
+
+            int read(uint8_t *buffer, size_t size) {
+                size_t count = (packet.size() - position < size ? packet.size() - position : size);
+                memcpy(buffer, packet.data() + position, count);
+                position += count;
+
+                return count;
+            }
+
+            int beginPacket(IPAddress ip, uint16_t port) {
+                sending.clear();
+
+                return 1;
+            }
+
+            size_t write(const uint8_t *buffer, size_t size) {
+                sending.insert(sending.end(), buffer, buffer + size);
+
+                return size;
+            }
+
+            int endPacket() {
+                lastSent = sending;
+
+                return 1;
+            }
+
+            /*
+             * Test hook, not part of WiFiUDP. Queues a packet to be received.
+             */
+            static void nativeQueue(const uint8_t *data, size_t size) {
+                received.emplace_back(data, data + size);
+            }
+    };
+#endif
@@ -0,0 +1,23 @@
+/*
+  c_types - The ESP8266 SDK's integer types, for building the libraries
+  on the host. Part of the stand-ins used by the native test environment,
+  see test/README.
+*/
+
+#ifndef c_types_h
+    #define c_types_h
+
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <sys/types.h>
+
+    typedef uint8_t uint8;
+    typedef int8_t sint8;
+    typedef uint16_t uint16;
+    typedef int16_t sint16;
+    typedef uint32_t uint32;
+    typedef int32_t sint32;
+    typedef uint64_t uint64;
+    typedef int64_t sint64;
+    typedef unsigned long ulong;
+#endif
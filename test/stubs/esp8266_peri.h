@@ -0,0 +1,36 @@
+/*
+  esp8266_peri - The UART registers as plain variables, so the UART driver
+  builds on the host. Nothing is sent anywhere and the FIFO always reads as
+  empty. Part of the stand-ins used by the native test environment, see
+  test/README.
+*/
+
+#ifndef esp8266_peri_h
+    #define esp8266_peri_h
+
+    #include <stdint.h>
+
+    namespace Native {
+        inline volatile uint32_t uartRegisters[2][8];
+    }
+
+    #define UART0 0
+    #define UART1 1
+
+    #define USF(u) Native::uartRegisters[u][0]
+    #define USIS(u) Native::uartRegisters[u][1]
+    #define USIC(u) Native::uartRegisters[u][2]
+    #define USIE(u) Native::uartRegisters[u][3]
+    #define USS(u) Native::uartRegisters[u][4]
+    #define USC0(u) Native::uartRegisters[u][5]
+    #define USC1(u) Native::uartRegisters[u][6]
+
+    #define UIFE 1
+    #define USTXC 16
+    #define UCTXI 22
+    #define UCFET 8
+
+    #define ETS_UART_INTR_ATTACH(handler, arg) ((void) (handler), (void) (arg))
+    #define ETS_UART_INTR_ENABLE()
+    #define ETS_UART_INTR_DISABLE()
+#endif
@@ -0,0 +1,29 @@
+/*
+  pgmspace - PROGMEM is plain memory on the host, so the _P functions
+  are the ordinary ones. Part of the stand-ins used by the native test
+  environment, see test/README.
+*/
+
+#ifndef pgmspace_h
+    #define pgmspace_h
+
+    #include <string.h>
+    #include <c_types.h>
+
+    #define PROGMEM
+    #define PGM_P const char *
+    #define PSTR(s) (s)
+
+    #define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+    #define pgm_read_word(addr) (*(const uint16_t *) (addr))
+    #define pgm_read_dword(addr) (*(const uint32_t *) (addr))
+    #define pgm_read_ptr(addr) (*(void *const *) (addr))
+
+    #define memcpy_P memcpy
+    #define memcmp_P memcmp
+    #define strlen_P strlen
+    #define strcmp_P strcmp
+    #define strncmp_P strncmp
+    #define strcpy_P strcpy
+    #define strncpy_P strncpy
+#endif
@@ -0,0 +1,454 @@
+/*
+  Benchmarks - Times the work done on every frame and every request on the
+  host: each effect rendering strips of several lengths, the color codec
+  against the one it replaced, saving and loading the settings, the state
+  API and streaming the control page. Host times don't match the ESP8266's, but
+  they show how the costs compare and whether a change made one slower. The
+  results are printed, run with `pio test -e native -f test_benchmark -v`.
+*/
+
+#include <chrono>
+#include <map>
+#include <unity.h>
+#include <Lighting.h>
+#include <Settings.h>
+#include <PageWriter.h>
+#include <WebAssets.h>
+#include <StateApi.h>
+
+const uint BENCHMARK_STRIP_LENGTHS[] = {11u, 50u, 150u, 300u, 600u};
+const unsigned long BENCHMARK_FRAMES = 2000ul;
+const unsigned long BENCHMARK_SAVES = 2000ul;
+const unsigned long BENCHMARK_LOADS = 2000ul;
+const unsigned long BENCHMARK_PAGES = 2000ul;
+const unsigned long BENCHMARK_COLORS = 30000ul;
+const unsigned long BENCHMARK_REQUESTS = 20000ul;
+
+// The One Direction Chase program from the README
+const uint8 CHASE_PATTERN[] = {
+    0x0E, 0x05, 0x01, 0x00,
+    0x12, 0x05, 0x00, 0x05,
+    0x06, 0x06, 0x01, 0x04,
+    0x0E, 0x06, 0x06, 0x00,
+    0x07, 0x06, 0x06, 0x01,
+    0x01, 0x07, 0x01, 0x00,
+    0x20, 0x00, 0x06, 0x07
+};
+
+const uint8 GRADIENT_COLORS[][3] = {
+    {0xFF, 0x00, 0x00}, {0xFF, 0xFF, 0x00}, {0x00, 0xFF, 0x00},
+    {0x00, 0xFF, 0xFF}, {0x00, 0x00, 0xFF}, {0xFF, 0x00, 0xFF}
+};
+
+/*
+ * The settings layouts older firmware stored, laid out as on the ESP8266
+ * where unsigned long and unsigned int are both 32 bits.
+ */
+struct NVSettingsV1 {
+    uint32           magic                                       ;
+    uint8            version                                     ;
+    uint8            actionId                                    ;
+    uint8            colorsSize                                  ;
+    uint8            reserved                                    ;
+    uint32           actionDelay                                 ;
+    uint8            colors         [MAX_SETTINGS_COLORS][3]     ;
+    uint8            padding        [3]                          ;
+    uint32           crc                                         ;
+};
+
+struct LegacyNVSettings {
+    char             actionName     [100]    ;
+    uint32           actionDelay             ;
+    char             colors         [100]    ;
+    uint32           colorsSize              ;
+    char             sentinel       [33]     ;
+};
+
+// As Settings reads it on the host, where unsigned long is 64 bits
+struct HostLegacyNVSettings {
+    char             actionName     [100]    ;
+    unsigned long    actionDelay             ;
+    char             colors         [100]    ;
+    unsigned int     colorsSize              ;
+    char             sentinel       [33]     ;
+};
+
+const char *const BENCHMARK_COLOR_LISTS[] = {"ff0000:00ff00:0000ff", "12ab0f:800001:fedcba", "000000:ffffff:7f7f7f", "0a0b0c:d0e0f0:123456"};
+
+/*
+ * The hex codec as it was before, which looked up a one char String
+ * in a std::map for every digit. Kept here to compare against.
+ */
+namespace Legacy {
+    std::map<String, uint8> hexToDecDigitMap {
+        {"0", 0u}, {"1", 1u}, {"2", 2u}, {"3", 3u}, {"4", 4u}, {"5", 5u}, {"6", 6u}, {"7", 7u},
+        {"8", 8u}, {"9", 9u}, {"a", 10u}, {"b", 11u}, {"c", 12u}, {"d", 13u}, {"e", 14u}, {"f", 15u}
+    };
+
+    std::map<uint8, String> decToHexDigitMap {
+        {0u, "0"}, {1u, "1"}, {2u, "2"}, {3u, "3"}, {4u, "4"}, {5u, "5"}, {6u, "6"}, {7u, "7"},
+        {8u, "8"}, {9u, "9"}, {10u, "a"}, {11u, "b"}, {12u, "c"}, {13u, "d"}, {14u, "e"}, {15u, "f"}
+    };
+
+    uint8 hexTo8BitDecimal(String hex) {
+        hex.toLowerCase();
+        uint8 result = hexToDecDigitMap[hex.substring(0, 1)] << 4;
+
+        return result | hexToDecDigitMap[hex.substring(1, 2)];
+    }
+
+    String decimalTo8BitHex(uint8 dec) {
+        String result = "";
+        result.concat(decToHexDigitMap[dec >> 4]);
+        result.concat(decToHexDigitMap[dec & 0x0F]);
+
+        return result;
+    }
+
+    String rgbDecimalsToHex(uint8 red, uint8 green, uint8 blue) {
+        String result = "";
+        result.concat(decimalTo8BitHex(red));
+        result.concat(decimalTo8BitHex(green));
+        result.concat(decimalTo8BitHex(blue));
+
+        return result;
+    }
+
+    uint32 rgbStringToColor(String rgbString, uint beginIndex) {
+        uint8 red = hexTo8BitDecimal(rgbString.substring(beginIndex, beginIndex + 2));
+        uint8 green = hexTo8BitDecimal(rgbString.substring(beginIndex + 2, beginIndex + 4));
+        uint8 blue = hexTo8BitDecimal(rgbString.substring(beginIndex + 4, beginIndex + 6));
+
+        return ((uint32) red << 16) | ((uint32) green << 8) | blue;
+    }
+
+    void split(String string, char separator, String *storage, unsigned int sizeOfStorage) {
+        unsigned int index = 0;
+        for (unsigned int segmentIndex = 0; segmentIndex < sizeOfStorage && index < string.length(); segmentIndex++) {
+            unsigned int startIndex = index;
+            for (; index < string.length(); index++) {
+                if (string.charAt(index) == separator) {
+                    storage[segmentIndex] = string.substring(startIndex, index);
+                    index++;
+
+                    break;
+                } else if (index == (string.length() - 1)) {
+                    index++;
+                    storage[segmentIndex] = string.substring(startIndex, index);
+                }
+            }
+        }
+    }
+}
+
+CRGB benchmarkFrame[MAX_LEDS];
+volatile uint32 benchmarkSink = 0ul; // Keeps the work from being optimised away
+
+unsigned long long nanosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, const char *detail, unsigned long long nanos, unsigned long count, const char *unit) {
+    char message[128];
+    snprintf(message, sizeof(message), "%-20s %-12s %8llu ns/%s", name, detail, nanos / count, unit);
+    TEST_MESSAGE(message);
+}
+
+void setUp(void) {
+    LittleFS.format();
+    EEPROM.nativeReset();
+}
+
+void tearDown(void) {}
+
+void benchmarkEffects(void) {
+    TEST_ASSERT_TRUE(patternVm.setProgram(CHASE_PATTERN, sizeof(CHASE_PATTERN) / PATTERN_INSTRUCTION_SIZE));
+
+    uint32 crc = Utils::crc32(GRADIENT_COLORS[0], sizeof(GRADIENT_COLORS));
+    TEST_ASSERT_TRUE(gradientPalette.beginSave(6u, crc));
+    for (unsigned int i = 0u; i < 6u; i++) {
+        TEST_ASSERT_TRUE(gradientPalette.saveColor(GRADIENT_COLORS[i]));
+    }
+    TEST_ASSERT_TRUE(gradientPalette.endSave());
+    TEST_ASSERT_TRUE(gradientPalette.service(true));
+    TEST_ASSERT_NOT_NULL(gradientPalette.getGradient());
+
+    Palette palette = {{CRGB(0xFF0000ul), CRGB(0x00FF00ul), CRGB(0x0000FFul)}, 3u, nullptr};
+    Palette gradient = palette;
+    gradient.gradient = gradientPalette.getGradient();
+
+    for (uint effectId = 0u; effectId < EFFECT_COUNT; effectId++) {
+        for (uint numLeds : BENCHMARK_STRIP_LENGTHS) {
+            const Palette &used = (effectId == EFFECT_PALETTE_GRADIENT ? gradient : palette);
+            FrameTime time = {0ull, 0ull, 0u};
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned long frame = 0ul; frame < BENCHMARK_FRAMES; frame++) {
+                time.step = frame;
+                time.elapsedMicros = frame * 70000ull;
+                EFFECTS[effectId]->render(benchmarkFrame, numLeds, time, used);
+                benchmarkSink += benchmarkFrame[frame % numLeds].raw[0];
+            }
+            char detail[16];
+            snprintf(detail, sizeof(detail), "%u leds", numLeds);
+            report(EFFECT_DESCRIPTORS[effectId].name, detail, nanosSince(start), BENCHMARK_FRAMES, "frame");
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0ul, patternVm.getOverBudgetFrames());
+}
+
+/*
+ * Each part of the color codec against the String and std::map code it
+ * replaced, both fed the same colors and checked to agree.
+ */
+void benchmarkColorCodec(void) {
+    const unsigned int listCount = sizeof(BENCHMARK_COLOR_LISTS) / sizeof(BENCHMARK_COLOR_LISTS[0]);
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long color = 0ul; color < BENCHMARK_COLORS; color++) {
+        const char *hex = &BENCHMARK_COLOR_LISTS[color % listCount][(color % 3u) * 7u];
+        benchmarkSink += Legacy::hexTo8BitDecimal(String(hex).substring(0, 2));
+        benchmarkSink += Legacy::hexTo8BitDecimal(String(hex).substring(2, 4));
+        benchmarkSink += Legacy::hexTo8BitDecimal(String(hex).substring(4, 6));
+    }
+    report("hexTo8BitDecimal", "String+map", nanosSince(start), BENCHMARK_COLORS, "color");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long color = 0ul; color < BENCHMARK_COLORS; color++) {
+        const char *hex = &BENCHMARK_COLOR_LISTS[color % listCount][(color % 3u) * 7u];
+        uint8 red, green, blue;
+        TEST_ASSERT_TRUE(Utils::hexTo8BitDecimal(&hex[0], red) && Utils::hexTo8BitDecimal(&hex[2], green) && Utils::hexTo8BitDecimal(&hex[4], blue));
+        benchmarkSink += red + green + blue;
+    }
+    report("hexTo8BitDecimal", "now", nanosSince(start), BENCHMARK_COLORS, "color");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long color = 0ul; color < BENCHMARK_COLORS; color++) {
+        benchmarkSink += Legacy::rgbStringToColor(BENCHMARK_COLOR_LISTS[color % listCount], (color % 3u) * 7u);
+    }
+    report("rgbHexToDecimal", "String+map", nanosSince(start), BENCHMARK_COLORS, "color");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long color = 0ul; color < BENCHMARK_COLORS; color++) {
+        uint32 rgb = 0ul;
+        TEST_ASSERT_TRUE(Utils::rgbHexToDecimal(&BENCHMARK_COLOR_LISTS[color % listCount][(color % 3u) * 7u], rgb));
+        benchmarkSink += rgb;
+    }
+    report("rgbHexToDecimal", "now", nanosSince(start), BENCHMARK_COLORS, "color");
+
+    const unsigned long lists = BENCHMARK_COLORS / MAX_COLORS;
+    start = std::chrono::steady_clock::now();
+    for (unsigned long list = 0ul; list < lists; list++) {
+        String colors[MAX_COLORS] = {"000000"};
+        Legacy::split(BENCHMARK_COLOR_LISTS[list % listCount], ':', colors, MAX_COLORS);
+        for (uint i = 0u; i < MAX_COLORS; i++) {
+            benchmarkSink += Legacy::rgbStringToColor(colors[i], 0u);
+        }
+    }
+    report("parseRgbHexList", "String+map", nanosSince(start), lists * MAX_COLORS, "color");
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long list = 0ul; list < lists; list++) {
+        uint32 rgbs[MAX_COLORS];
+        TEST_ASSERT_EQUAL_UINT(MAX_COLORS, Utils::parseRgbHexList(BENCHMARK_COLOR_LISTS[list % listCount], ':', rgbs, MAX_COLORS));
+        benchmarkSink += rgbs[0] + rgbs[1] + rgbs[2];
+    }
+    report("parseRgbHexList", "now", nanosSince(start), lists * MAX_COLORS, "color");
+
+    uint32 rgbs[MAX_COLORS] = {0x12AB0Ful, 0x800001ul, 0xFEDCBAul};
+    String legacyList;
+    start = std::chrono::steady_clock::now();
+    for (unsigned long list = 0ul; list < lists; list++) {
+        rgbs[0] = list & 0xFFFFFFul;
+        legacyList = "";
+        for (uint i = 0u; i < MAX_COLORS; i++) {
+            if (i > 0u) {
+                legacyList.concat(":");
+            }
+            legacyList.concat(Legacy::rgbDecimalsToHex(rgbs[i] >> 16, rgbs[i] >> 8, rgbs[i]));
+        }
+        benchmarkSink += legacyList.length();
+    }
+    report("formatRgbHexList", "String+map", nanosSince(start), lists * MAX_COLORS, "color");
+
+    char list[MAX_COLORS * 7u];
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0ul; i < lists; i++) {
+        rgbs[0] = i & 0xFFFFFFul;
+        benchmarkSink += Utils::formatRgbHexList(rgbs, MAX_COLORS, ':', list, sizeof(list));
+    }
+    report("formatRgbHexList", "now", nanosSince(start), lists * MAX_COLORS, "color");
+    TEST_ASSERT_EQUAL_STRING(legacyList.c_str(), list);
+
+    for (const char *colors : BENCHMARK_COLOR_LISTS) {
+        TEST_ASSERT_EQUAL_UINT(MAX_COLORS, Utils::parseRgbHexList(colors, ':', rgbs, MAX_COLORS));
+        for (uint i = 0u; i < MAX_COLORS; i++) {
+            TEST_ASSERT_EQUAL_HEX32(Legacy::rgbStringToColor(colors, i * 7u), rgbs[i]);
+        }
+    }
+}
+
+void benchmarkSettingsSave(void) {
+    Settings settings;
+    settings.loadSettings();
+    unsigned long written = settings.getSaveCount();
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long save = 0ul; save < BENCHMARK_SAVES; save++) {
+        settings.setColor(0u, save & 0xFFFFFFul);
+        TEST_ASSERT_TRUE(settings.saveSettings());
+    }
+    report("settings", "changed", nanosSince(start), BENCHMARK_SAVES, "save");
+    TEST_ASSERT_EQUAL_UINT32(written + BENCHMARK_SAVES, settings.getSaveCount());
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long save = 0ul; save < BENCHMARK_SAVES; save++) {
+        TEST_ASSERT_TRUE(settings.saveSettings());
+    }
+    report("settings", "unchanged", nanosSince(start), BENCHMARK_SAVES, "save");
+    TEST_ASSERT_EQUAL_UINT32(written + BENCHMARK_SAVES, settings.getSaveCount());
+}
+
+/**
+ * Times loading the record stored, restoring it before each load as a
+ * migration saves over it. Only the loads are timed.
+ */
+void timeSettingsLoad(const char *detail, const void *record, size_t size) {
+    unsigned long long nanos = 0ull;
+    for (unsigned long load = 0ul; load < BENCHMARK_LOADS; load++) {
+        EEPROM.nativeReset();
+        EEPROM.nativeStore(record, size);
+        Settings settings;
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(settings.loadSettings());
+        nanos += nanosSince(start);
+        benchmarkSink += settings.getActionId();
+    }
+    report("settings", detail, nanos, BENCHMARK_LOADS, "load");
+}
+
+void benchmarkSettingsLoad(void) {
+    Settings saved;
+    saved.setColor(1u, 0x405060ul);
+    saved.setColorsSize(2u);
+    TEST_ASSERT_TRUE(saved.saveSettings());
+    uint8 record[SETTINGS_STORAGE_SIZE];
+    memcpy(record, EEPROM.nativeStored(), sizeof(record));
+    timeSettingsLoad("current", record, sizeof(record));
+
+    NVSettingsV1 v1;
+    memset(&v1, 0, sizeof(v1));
+    v1.magic = SETTINGS_MAGIC;
+    v1.version = 1u;
+    v1.actionId = 3u;
+    v1.colorsSize = 3u;
+    v1.actionDelay = 120ul;
+    v1.crc = Utils::crc32((const uint8 *) &v1, offsetof(NVSettingsV1, crc));
+    timeSettingsLoad("from v1", &v1, sizeof(v1));
+
+    HostLegacyNVSettings legacy;
+    memset(&legacy, 0, sizeof(legacy));
+    strcpy(legacy.actionName, "backAndForthChase");
+    legacy.actionDelay = 45ul;
+    strcpy(legacy.colors, "ff8000:0080ff");
+    legacy.colorsSize = 2u;
+    String content = String(legacy.actionName) + String(legacy.actionDelay) + String(legacy.colors) + String(legacy.colorsSize);
+    strcpy(legacy.sentinel, Utils::hashString(content).c_str());
+    timeSettingsLoad("from legacy", &legacy, sizeof(legacy));
+
+    // The space the record takes in flash, the legacy one as on the ESP8266
+    uint16 recordLength;
+    memcpy(&recordLength, &record[6], sizeof(recordLength));
+    char message[128];
+    snprintf(message, sizeof(message), "%-20s %u bytes of %u reserved, %u records per sector erase",
+        "settings record", recordLength, SETTINGS_STORAGE_SIZE, EEPROM.slotCount(SETTINGS_STORAGE_SIZE));
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "%-20s %u bytes, %u records per sector erase",
+        "legacy record", (unsigned int) sizeof(LegacyNVSettings), EEPROM.slotCount(sizeof(LegacyNVSettings)));
+    TEST_MESSAGE(message);
+}
+
+void reportRequest(const char *name, const char *detail, unsigned long long nanos, unsigned long count, size_t bytes) {
+    char message[128];
+    snprintf(message, sizeof(message), "%-20s %-12s %8llu ns/request %6u bytes", name, detail, nanos / count, (unsigned int) bytes);
+    TEST_MESSAGE(message);
+}
+
+/*
+ * The state API beside the control page, each run through the web
+ * server as the device runs it, with the bytes each sends.
+ */
+void benchmarkStateApi(void) {
+    ESP8266WebServer server;
+    StripConfig strip = {150u, 5u, 2u};
+    Palette palette = {{CRGB(0xFF0000ul), CRGB(0x00FF00ul), CRGB(0x0000FFul)}, 3u, nullptr};
+    effectEngine.setPalette(palette);
+    effectEngine.setEffect(2u);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long request = 0ul; request < BENCHMARK_REQUESTS; request++) {
+        server.nativeReset();
+        sendState(server, strip);
+    }
+    reportRequest("GET /api/state", "json", nanosSince(start), BENCHMARK_REQUESTS, server.response.size());
+    TEST_ASSERT_EQUAL(200, server.responseCode);
+    TEST_ASSERT_EQUAL_STRING("{\"action\":2,\"delayMicros\":70000,\"colors\":[\"#ff0000\",\"#00ff00\",\"#0000ff\"],\"ledCount\":150,\"dataPin\":5,\"colorOrder\":2}", server.response.c_str());
+
+    server.nativeSetArgs({{"plain", "{\"action\":3,\"delayMicros\":50000,\"color1\":\"#ff8000\"}"}});
+    start = std::chrono::steady_clock::now();
+    for (unsigned long request = 0ul; request < BENCHMARK_REQUESTS; request++) {
+        server.nativeReset();
+        TEST_ASSERT_TRUE(patchState(server, strip));
+    }
+    reportRequest("PATCH /api/state", "json", nanosSince(start), BENCHMARK_REQUESTS, server.response.size());
+    TEST_ASSERT_EQUAL(3u, effectEngine.getEffectId());
+    TEST_ASSERT_EQUAL_UINT8(0x80u, effectEngine.getPalette().colors[1].g);
+
+    server.nativeSetArgs({{"plain", "{\"action\":3,\"color1\":\"#ff80\"}"}});
+    start = std::chrono::steady_clock::now();
+    for (unsigned long request = 0ul; request < BENCHMARK_REQUESTS; request++) {
+        server.nativeReset();
+        TEST_ASSERT_FALSE(patchState(server, strip));
+    }
+    reportRequest("PATCH /api/state", "invalid", nanosSince(start), BENCHMARK_REQUESTS, server.response.size());
+    TEST_ASSERT_EQUAL(400, server.responseCode);
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long request = 0ul; request < BENCHMARK_REQUESTS; request++) {
+        server.nativeReset();
+        PageWriter writer(server);
+        writer.begin(200, "text/html");
+        writer.write_P((PGM_P) INDEX_HTML_GZ, INDEX_HTML_GZ_SIZE);
+        writer.end();
+    }
+    reportRequest("GET /", "gzip", nanosSince(start), BENCHMARK_REQUESTS, server.response.size());
+}
+
+/*
+ * The control page is sent as it was compressed at build time, so the
+ * cost of a page is that of streaming it through a PageWriter.
+ */
+void benchmarkPage(void) {
+    ESP8266WebServer server;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long page = 0ul; page < BENCHMARK_PAGES; page++) {
+        server.nativeReset();
+        PageWriter writer(server);
+        writer.begin(200, "text/html");
+        writer.write_P((PGM_P) INDEX_HTML_GZ, INDEX_HTML_GZ_SIZE);
+        writer.end();
+    }
+    report("index.html", "gzip", nanosSince(start), BENCHMARK_PAGES, "page");
+    TEST_ASSERT_EQUAL_size_t(INDEX_HTML_GZ_SIZE, server.response.size());
+    TEST_ASSERT_EQUAL_MEMORY(INDEX_HTML_GZ, server.response.data(), INDEX_HTML_GZ_SIZE);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(benchmarkEffects);
+    RUN_TEST(benchmarkColorCodec);
+    RUN_TEST(benchmarkSettingsSave);
+    RUN_TEST(benchmarkSettingsLoad);
+    RUN_TEST(benchmarkStateApi);
+    RUN_TEST(benchmarkPage);
+
+    return UNITY_END();
+}
@@ -0,0 +1,231 @@
+/*
+  ControlForm - Runs posts of the control page form through decodeForm(),
+  a table of valid and invalid values followed by posts of random names
+  and values, and checks that nothing out of range is ever accepted.
+*/
+
+#include <string>
+#include <vector>
+#include <unity.h>
+#include <ControlForm.h>
+
+#define FUZZ_POSTS 200000ul
+
+ESP8266WebServer server(80);
+
+struct FormCase {
+    std::vector<std::pair<String, String>>   args                    ;
+    const char                               *invalidField           ; // nullptr if the post is valid
+};
+
+const FormCase INVALID_CASES[] = {
+    { { { "do", "delete" } }, "Button" },
+    { { { "action", "" } }, "Action" },
+    { { { "action", "-1" } }, "Action" },
+    { { { "action", "+1" } }, "Action" },
+    { { { "action", "1a" } }, "Action" },
+    { { { "action", String(EFFECT_COUNT) } }, "Action" },
+    { { { "changeDelay", "" } }, "Change delay" },
+    { { { "changeDelay", ".5" } }, "Change delay" },
+    { { { "changeDelay", "1.2345" } }, "Change delay" },
+    { { { "changeDelay", "1.2e" } }, "Change delay" },
+    { { { "changeDelay", "1..2" } }, "Change delay" },
+    { { { "changeDelay", "60000.001" } }, "Change delay" },
+    { { { "changeDelay", "60001" } }, "Change delay" },
+    { { { "changeDelay", "4294967296" } }, "Change delay" },
+    { { { "selectColor0", "ff0000" } }, "Color" },
+    { { { "selectColor0", "#ff000" } }, "Color" },
+    { { { "selectColor0", "#ff00000" } }, "Color" },
+    { { { "selectColor0", "#gg0000" } }, "Color" },
+    { { { "selectColor3", "#ff0000" } }, "Color" },
+    { { { "selectColor10", "#ff0000" } }, "Color" },
+    { { { "selectColor", "#ff0000" } }, "Color" },
+    { { { "selectColor1", "#ff0000" } }, "Color" }, // Without the first
+    { { { "selectColor0", "#ff0000" }, { "selectColor2", "#0000ff" } }, "Color" },
+    { { { "ledCount", "0" } }, "LED count" },
+    { { { "ledCount", "601" } }, "LED count" },
+    { { { "ledCount", "" } }, "LED count" },
+    { { { "dataPin", "3" } }, "Data pin" },
+    { { { "dataPin", "258" } }, "Data pin" },
+    { { { "colorOrder", String(COLOR_ORDER_COUNT) } }, "Color order" },
+    { { { "syncRole", String(SYNC_ROLE_COUNT) } }, "Sync" },
+    { { { "syncRole", "2" } }, "Leader ID" }, // A follower without a leader
+    { { { "syncRole", "2" }, { "syncLeader", "   " } }, "Leader ID" },
+    { { { "syncLeader", "ABC-12" } }, "Leader ID" },
+    { { { "syncLeader", "ABCDEFG" } }, "Leader ID" },
+    { { { "action", "12345678901234567" } }, "A value" },
+    { { { "name", "12345678901234567" } }, "A value" }, // Even for arguments the form doesn't have
+    { { { "action", "x" }, { "ledCount", "0" } }, "Action" }, // The first invalid field is the one given
+    { { { "ledCount", "0" }, { "action", "x" } }, "LED count" }
+};
+
+FormCommand currentValues() {
+    FormCommand command = { 2u, 70000ul, { CRGB(0x0000FF), CRGB(0x000000), CRGB(0x000000) }, 1u, { 11u, 5u, 2u }, { SYNC_OFF, "" }, nullptr };
+
+    return command;
+}
+
+bool decode(const std::vector<std::pair<String, String>> &args, FormCommand &command) {
+    server.nativeSetArgs(args);
+    command = currentValues();
+
+    return decodeForm(server, command);
+}
+
+/**
+ * Checks that a command decodeForm() accepted could be applied as it is.
+ */
+void assertInRange(const FormCommand &command) {
+    TEST_ASSERT_NULL(command.invalidField);
+    TEST_ASSERT_TRUE(command.action < EFFECT_COUNT);
+    TEST_ASSERT_TRUE(command.delay <= MAX_STEP_MICROS);
+    TEST_ASSERT_TRUE(command.colorsSize >= 1u && command.colorsSize <= MAX_COLORS);
+    TEST_ASSERT_TRUE(command.strip.ledCount >= 1u && command.strip.ledCount <= MAX_LEDS);
+    TEST_ASSERT_TRUE(isValidDataPin(command.strip.dataPin));
+    TEST_ASSERT_TRUE(command.strip.colorOrder < COLOR_ORDER_COUNT);
+    TEST_ASSERT_TRUE(command.sync.role < SYNC_ROLE_COUNT);
+    size_t length = strnlen(command.sync.leaderId, SYNC_LEADER_ID_SIZE);
+    TEST_ASSERT_TRUE(length < SYNC_LEADER_ID_SIZE);
+    for (size_t i = 0u; i < length; i++) {
+        char c = command.sync.leaderId[i];
+        TEST_ASSERT_TRUE((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z'));
+    }
+    TEST_ASSERT_TRUE(command.sync.role != SYNC_FOLLOWER || length > 0u);
+}
+
+void setUp(void) {
+    server.nativeSetArgs({});
+}
+
+void tearDown(void) {}
+
+void testNothingPostedKeepsTheValues(void) {
+    FormCommand command;
+    TEST_ASSERT_TRUE(decode({}, command));
+    TEST_ASSERT_EQUAL(2u, command.action);
+    TEST_ASSERT_EQUAL_UINT32(70000ul, command.delay);
+    TEST_ASSERT_EQUAL(1u, command.colorsSize);
+    TEST_ASSERT_EQUAL_UINT8(0xFFu, command.colors[0].b);
+    TEST_ASSERT_EQUAL(11u, command.strip.ledCount);
+    TEST_ASSERT_NULL(command.invalidField);
+
+    TEST_ASSERT_TRUE(decode({ { "do", "update" }, { "unknown", "anything" } }, command));
+    TEST_ASSERT_EQUAL(2u, command.action);
+}
+
+void testFullPost(void) {
+    FormCommand command;
+    TEST_ASSERT_TRUE(decode({
+        { "action", "3" },
+        { "changeDelay", "12.5" },
+        { "selectColor0", "#FF8000" },
+        { "selectColor1", "#00ff7f" },
+        { "ledCount", "600" },
+        { "dataPin", "2" },
+        { "colorOrder", "0" },
+        { "syncRole", "2" },
+        { "syncLeader", "  ab12cd " },
+        { "do", "update" }
+    }, command));
+    TEST_ASSERT_EQUAL(3u, command.action);
+    TEST_ASSERT_EQUAL_UINT32(12500ul, command.delay);
+    TEST_ASSERT_EQUAL(2u, command.colorsSize);
+    TEST_ASSERT_EQUAL_UINT8(0xFFu, command.colors[0].r);
+    TEST_ASSERT_EQUAL_UINT8(0x80u, command.colors[0].g);
+    TEST_ASSERT_EQUAL_UINT8(0x00u, command.colors[0].b);
+    TEST_ASSERT_EQUAL_UINT8(0x7Fu, command.colors[1].b);
+    TEST_ASSERT_EQUAL(600u, command.strip.ledCount);
+    TEST_ASSERT_EQUAL(2u, command.strip.dataPin);
+    TEST_ASSERT_EQUAL(0u, command.strip.colorOrder);
+    TEST_ASSERT_EQUAL(SYNC_FOLLOWER, command.sync.role);
+    TEST_ASSERT_EQUAL_STRING("AB12CD", command.sync.leaderId);
+    assertInRange(command);
+}
+
+void testDelays(void) {
+    const struct {
+        const char *text;
+        unsigned long micros;
+    } delays[] = {
+        { "0", 0ul }, { "1", 1000ul }, { "1.", 1000ul }, { "0.5", 500ul }, { "0.05", 50ul },
+        { "1.234", 1234ul }, { "007", 7000ul }, { "60000", MAX_STEP_MICROS }, { "60000.000", MAX_STEP_MICROS }
+    };
+    FormCommand command;
+    for (const auto &delay : delays) {
+        TEST_ASSERT_TRUE_MESSAGE(decode({ { "changeDelay", delay.text } }, command), delay.text);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(delay.micros, command.delay, delay.text);
+    }
+}
+
+void testColorsReplaceAllOfTheColors(void) {
+    FormCommand command;
+    TEST_ASSERT_TRUE(decode({ { "selectColor2", "#000003" }, { "selectColor0", "#000001" }, { "selectColor1", "#000002" } }, command));
+    TEST_ASSERT_EQUAL(3u, command.colorsSize);
+    for (unsigned int i = 0u; i < 3u; i++) {
+        TEST_ASSERT_EQUAL_UINT8(i + 1u, command.colors[i].b);
+    }
+
+    TEST_ASSERT_TRUE(decode({ { "selectColor0", "#ffffff" } }, command)); // Down to one
+    TEST_ASSERT_EQUAL(1u, command.colorsSize);
+}
+
+void testInvalidPosts(void) {
+    for (const FormCase &formCase : INVALID_CASES) {
+        FormCommand command;
+        std::string post;
+        for (const auto &arg : formCase.args) {
+            post += std::string(arg.first.c_str()) + "=" + arg.second.c_str() + "&";
+        }
+        TEST_ASSERT_FALSE_MESSAGE(decode(formCase.args, command), post.c_str());
+        TEST_ASSERT_NOT_NULL(command.invalidField);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(formCase.invalidField, command.invalidField, post.c_str());
+    }
+}
+
+void testRandomPosts(void) {
+    const char *names[] = { "do", "action", "changeDelay", "selectColor0", "selectColor1", "selectColor2", "selectColor3", "ledCount", "dataPin", "colorOrder", "syncRole", "syncLeader", "other" };
+    const char alphabet[] = "0123456789012345.#abcdefABCXYZ -+\x80\xFF";
+    uint32 state = 0x2545F491ul;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        return state;
+    };
+
+    unsigned long accepted = 0ul;
+    for (unsigned long post = 0ul; post < FUZZ_POSTS; post++) {
+        std::vector<std::pair<String, String>> args;
+        unsigned int count = next() % 5u;
+        for (unsigned int i = 0u; i < count; i++) {
+            std::string value;
+            unsigned int length = next() % 19u;
+            for (unsigned int c = 0u; c < length; c++) {
+                value += alphabet[next() % (sizeof(alphabet) - 1u)];
+            }
+            args.push_back({ names[next() % (sizeof(names) / sizeof(names[0]))], String(value.c_str()) });
+        }
+
+        FormCommand command;
+        if (decode(args, command)) {
+            assertInRange(command);
+            accepted++;
+        } else {
+            TEST_ASSERT_NOT_NULL(command.invalidField);
+        }
+    }
+    TEST_ASSERT_TRUE(accepted > FUZZ_POSTS / 100ul); // Enough got through to check what was accepted
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testNothingPostedKeepsTheValues);
+    RUN_TEST(testFullPost);
+    RUN_TEST(testDelays);
+    RUN_TEST(testColorsReplaceAllOfTheColors);
+    RUN_TEST(testInvalidPosts);
+    RUN_TEST(testRandomPosts);
+
+    return UNITY_END();
+}
@@ -0,0 +1,238 @@
+/*
+  DdpReceiver - Feeds DDP packets through the stand-in UDP socket and
+  checks where their pixel data lands, what is refused, how the sequence
+  numbers are counted, and that the EffectEngine only shows an external
+  frame once it is pushed.
+*/
+
+#include <vector>
+#include <unity.h>
+#include <DdpReceiver.h>
+#include <Lighting.h>
+
+#define FRAME_SIZE 60u // 20 pixels
+#define GUARD 0xEEu
+
+/**
+ * Keeps the last frame shown so the effect's output can be checked.
+ */
+class CapturingOutput : public LedOutput {
+    public:
+        CRGB frame[MAX_LEDS];
+        unsigned long shown = 0ul;
+
+        bool isBusy() override {
+            return false;
+        }
+
+        void show(const CRGB *frame, uint numLeds) override {
+            memcpy(this->frame, frame, numLeds * sizeof(CRGB));
+            shown++;
+        }
+};
+
+uint8_t frame[FRAME_SIZE + 8u]; // With guard bytes past its end
+
+/**
+ * Queues a packet whose data is the bytes from first upwards.
+ */
+void queuePacket(uint8_t flags, uint8_t sequence, uint32_t offset, uint16_t length, uint8_t first, bool timecode = false, uint8_t dataType = 0x0Bu, uint8_t destination = DDP_ID_DISPLAY) {
+    std::vector<uint8_t> packet = {
+        (uint8_t) (DDP_FLAG_VERSION_1 | flags | (timecode ? DDP_FLAG_TIMECODE : 0u)),
+        sequence,
+        dataType,
+        destination,
+        (uint8_t) (offset >> 24), (uint8_t) (offset >> 16), (uint8_t) (offset >> 8), (uint8_t) offset,
+        (uint8_t) (length >> 8), (uint8_t) length
+    };
+    if (timecode) {
+        packet.insert(packet.end(), {0x01, 0x02, 0x03, 0x04});
+    }
+    for (uint16_t i = 0u; i < length; i++) {
+        packet.push_back(first + i);
+    }
+    WiFiUDP::nativeQueue(packet.data(), packet.size());
+}
+
+DdpResult receive(DdpReceiver &receiver) {
+    TEST_ASSERT_TRUE(receiver.available());
+
+    return receiver.read(frame, FRAME_SIZE);
+}
+
+void assertFrameBytes(unsigned int from, unsigned int count, uint8_t first) {
+    for (unsigned int i = 0u; i < count; i++) {
+        TEST_ASSERT_EQUAL_HEX8((uint8_t) (first + i), frame[from + i]);
+    }
+}
+
+void setUp(void) {
+    WiFiUDP::received.clear();
+    memset(frame, 0, FRAME_SIZE);
+    memset(&frame[FRAME_SIZE], GUARD, sizeof(frame) - FRAME_SIZE);
+}
+
+void tearDown(void) {}
+
+void testParseHeader(void) {
+    const uint8_t DATA[] = {0x41, 0x1A, 0x0B, 0x01, 0x00, 0x01, 0x02, 0x03, 0x01, 0x2C, 0xFF, 0xFF, 0xFF, 0xFF};
+    DdpHeader header;
+    TEST_ASSERT_TRUE(DdpReceiver::parseHeader(DATA, DDP_HEADER_SIZE, header));
+    TEST_ASSERT_EQUAL_HEX8(0x41, header.flags);
+    TEST_ASSERT_EQUAL_UINT8(0x0A, header.sequence);
+    TEST_ASSERT_EQUAL_HEX8(0x0B, header.dataType);
+    TEST_ASSERT_EQUAL_UINT8(DDP_ID_DISPLAY, header.destination);
+    TEST_ASSERT_EQUAL_HEX32(0x00010203ul, header.offset);
+    TEST_ASSERT_EQUAL_UINT16(300u, header.length);
+    TEST_ASSERT_EQUAL_UINT8(DDP_HEADER_SIZE, header.headerSize);
+
+    TEST_ASSERT_FALSE(DdpReceiver::parseHeader(DATA, DDP_HEADER_SIZE - 1u, header));
+
+    uint8_t other[sizeof(DATA)];
+    memcpy(other, DATA, sizeof(DATA));
+    other[0] = 0x81; // Version 2
+    TEST_ASSERT_FALSE(DdpReceiver::parseHeader(other, sizeof(other), header));
+    other[0] = 0x01; // Version 0
+    TEST_ASSERT_FALSE(DdpReceiver::parseHeader(other, sizeof(other), header));
+
+    other[0] = DDP_FLAG_VERSION_1 | DDP_FLAG_TIMECODE;
+    TEST_ASSERT_FALSE(DdpReceiver::parseHeader(other, DDP_HEADER_SIZE + DDP_TIMECODE_SIZE - 1u, header));
+    TEST_ASSERT_TRUE(DdpReceiver::parseHeader(other, sizeof(other), header));
+    TEST_ASSERT_EQUAL_UINT8(DDP_HEADER_SIZE + DDP_TIMECODE_SIZE, header.headerSize);
+}
+
+void testDataLandsAtItsOffset(void) {
+    DdpReceiver receiver;
+    TEST_ASSERT_TRUE(receiver.begin(DDP_PORT));
+    TEST_ASSERT_FALSE(receiver.available());
+
+    // Short packets end within the header's first read, longer ones go past it
+    const uint16_t LENGTHS[] = {1u, 2u, 3u, 4u, 5u, 30u};
+    unsigned int offset = 0u;
+    for (uint16_t length : LENGTHS) {
+        queuePacket(0u, 0u, offset, length, 0x10u + offset);
+        TEST_ASSERT_EQUAL(DDP_DATA, receive(receiver));
+        assertFrameBytes(offset, length, 0x10u + offset);
+        offset += length;
+    }
+    TEST_ASSERT_EQUAL_UINT(45u, offset);
+
+    queuePacket(DDP_FLAG_PUSH, 0u, 45u, 15u, 0x80u, true);
+    TEST_ASSERT_EQUAL(DDP_PUSH, receive(receiver));
+    assertFrameBytes(0u, 45u, 0x10u);
+    assertFrameBytes(45u, 15u, 0x80u);
+    TEST_ASSERT_EQUAL_UINT32(7ul, receiver.getPacketCount());
+    TEST_ASSERT_EQUAL_UINT32(1ul, receiver.getFrameCount());
+}
+
+void testDataPastTheFrameIsDropped(void) {
+    DdpReceiver receiver;
+    queuePacket(0u, 0u, FRAME_SIZE - 10u, 30u, 0x20u);
+    TEST_ASSERT_EQUAL(DDP_DATA, receive(receiver));
+    assertFrameBytes(FRAME_SIZE - 10u, 10u, 0x20u);
+
+    queuePacket(0u, 0u, FRAME_SIZE - 2u, 3u, 0x40u); // Within the header's first read
+    TEST_ASSERT_EQUAL(DDP_DATA, receive(receiver));
+    assertFrameBytes(FRAME_SIZE - 2u, 2u, 0x40u);
+
+    queuePacket(DDP_FLAG_PUSH, 0u, FRAME_SIZE, 12u, 0x60u);
+    TEST_ASSERT_EQUAL(DDP_PUSH, receive(receiver));
+    queuePacket(0u, 0u, 0xFFFFFFF0ul, 12u, 0x60u);
+    TEST_ASSERT_EQUAL(DDP_DATA, receive(receiver));
+
+    for (unsigned int i = FRAME_SIZE; i < sizeof(frame); i++) {
+        TEST_ASSERT_EQUAL_HEX8(GUARD, frame[i]);
+    }
+    for (unsigned int i = 0u; i < FRAME_SIZE - 10u; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x00u, frame[i]); // Untouched
+    }
+}
+
+void testPacketsRefused(void) {
+    DdpReceiver receiver;
+    queuePacket(DDP_FLAG_QUERY, 0u, 0u, 3u, 0x10u);
+    TEST_ASSERT_EQUAL(DDP_IGNORED, receive(receiver));
+    queuePacket(0u, 0u, 0u, 3u, 0x10u, false, 0x0Bu, 2u); // Another destination
+    TEST_ASSERT_EQUAL(DDP_IGNORED, receive(receiver));
+    queuePacket(0u, 0u, 0u, 3u, 0x10u, false, 0x1Bu); // 16 bit RGB
+    TEST_ASSERT_EQUAL(DDP_IGNORED, receive(receiver));
+    TEST_ASSERT_EQUAL_UINT32(3ul, receiver.getPacketCount());
+    TEST_ASSERT_EQUAL_UINT32(0ul, receiver.getMalformedPackets());
+
+    queuePacket(0u, 0u, 0u, 3u, 0x10u, false, 0x01u, DDP_ID_ALL);
+    TEST_ASSERT_EQUAL(DDP_DATA, receive(receiver));
+    assertFrameBytes(0u, 3u, 0x10u);
+
+    const uint8_t SHORT[] = {0x41, 0x00, 0x0B, 0x01, 0x00};
+    WiFiUDP::nativeQueue(SHORT, sizeof(SHORT));
+    TEST_ASSERT_EQUAL(DDP_IGNORED, receive(receiver));
+    const uint8_t TRUNCATED[] = {0x41, 0x00, 0x0B, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xAA, 0xBB};
+    WiFiUDP::nativeQueue(TRUNCATED, sizeof(TRUNCATED)); // Claims 9 bytes of data, has 2
+    TEST_ASSERT_EQUAL(DDP_IGNORED, receive(receiver));
+    TEST_ASSERT_EQUAL_UINT32(2ul, receiver.getMalformedPackets());
+    TEST_ASSERT_EQUAL_HEX8(0x10u, frame[0]);
+}
+
+void testSequenceTracking(void) {
+    DdpReceiver receiver;
+    const uint8_t SEQUENCE[] = {1u, 2u, 3u, 5u, 4u, 6u, 12u, 15u, 1u, 2u, 0u, 2u, 9u};
+    for (uint8_t sequence : SEQUENCE) {
+        queuePacket(0u, sequence, 0u, 3u, 0x10u);
+        receive(receiver);
+    }
+    /*
+     * 5 skips 4, which then comes late. 12 skips 7 to 11, 15 skips 13 and 14
+     * and 1 follows 15. 0 isn't numbered and 2 again is taken as late. 9
+     * skips 3 to 8.
+     */
+    TEST_ASSERT_EQUAL_UINT32(1ul - 1ul + 5ul + 2ul - 1ul + 6ul, receiver.getLostPackets());
+    TEST_ASSERT_EQUAL_UINT32(2ul, receiver.getOutOfOrderPackets());
+}
+
+void testExternalFrameShownOncePushed(void) {
+    const uint NUM_LEDS = FRAME_SIZE / 3u;
+    static CRGB frames[NUM_LEDS * 3u];
+    CapturingOutput output;
+    EffectEngine engine;
+    engine.begin(frames, NUM_LEDS, &output);
+    engine.setEffect(EFFECT_SOLID_COLORS);
+    engine.setPalette({{CRGB(0x0000FFul)}, 1u, nullptr});
+    TEST_ASSERT_TRUE(engine.service(0ull));
+    TEST_ASSERT_TRUE(output.frame[0] == CRGB(0x0000FFul));
+
+    DdpReceiver receiver;
+    CRGB *back = engine.beginExternalFrame();
+    queuePacket(0u, 0u, 0u, 30u, 0x10u);
+    TEST_ASSERT_TRUE(receiver.available());
+    TEST_ASSERT_EQUAL(DDP_DATA, receiver.read(back[0].raw, NUM_LEDS * 3u));
+    TEST_ASSERT_FALSE(engine.service(10000ull)); // Half a frame isn't shown
+    TEST_ASSERT_EQUAL_UINT32(1ul, output.shown);
+
+    queuePacket(DDP_FLAG_PUSH, 0u, 30u, 30u, 0x2Eu);
+    TEST_ASSERT_TRUE(receiver.available());
+    TEST_ASSERT_EQUAL(DDP_PUSH, receiver.read(back[0].raw, NUM_LEDS * 3u));
+    engine.pushExternalFrame();
+    TEST_ASSERT_TRUE(engine.service(20000ull));
+    TEST_ASSERT_EQUAL_UINT32(2ul, output.shown);
+    const uint8_t *shown = (const uint8_t *) output.frame;
+    for (uint i = 0u; i < NUM_LEDS * 3u; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x10u + i, shown[i]);
+    }
+    TEST_ASSERT_FALSE(engine.service(30000ull));
+
+    engine.endExternal();
+    TEST_ASSERT_TRUE(engine.service(40000ull));
+    TEST_ASSERT_TRUE(output.frame[NUM_LEDS - 1u] == CRGB(0x0000FFul));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testParseHeader);
+    RUN_TEST(testDataLandsAtItsOffset);
+    RUN_TEST(testDataPastTheFrameIsDropped);
+    RUN_TEST(testPacketsRefused);
+    RUN_TEST(testSequenceTracking);
+    RUN_TEST(testExternalFrameShownOncePushed);
+
+    return UNITY_END();
+}
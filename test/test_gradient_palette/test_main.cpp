@@ -0,0 +1,178 @@
+/*
+  GradientPalette - Saves palettes to LittleFS and reads them back, both as
+  colors and as the gradient worked out from them. A full palette must come
+  back as it went in, a truncated file or one failing its CRC must leave no
+  palette, and the gradient must pass through each stored color where that
+  color falls.
+*/
+
+#include <vector>
+#include <unity.h>
+#include <GradientPalette.h>
+
+uint32 randomState = 1ul;
+
+uint8 nextRandom() {
+    randomState = (randomState * 1103515245ul) + 12345ul;
+
+    return (uint8) (randomState >> 16);
+}
+
+std::vector<uint8> randomColors(unsigned int count) {
+    std::vector<uint8> colors(count * 3u);
+    for (uint8 &value : colors) {
+        value = nextRandom();
+    }
+
+    return colors;
+}
+
+/**
+ * Saves the given colors as the palette under the given CRC.
+ */
+void savePalette(GradientPalette &palette, const std::vector<uint8> &colors, uint32 crc) {
+    TEST_ASSERT_TRUE(palette.beginSave(colors.size() / 3u, crc));
+    for (size_t i = 0u; i < colors.size(); i += 3u) {
+        TEST_ASSERT_TRUE(palette.saveColor(&colors[i]));
+    }
+    TEST_ASSERT_TRUE(palette.endSave());
+}
+
+void savePalette(GradientPalette &palette, const std::vector<uint8> &colors) {
+    savePalette(palette, colors, Utils::crc32(colors.data(), colors.size()));
+}
+
+std::vector<uint8> readFile() {
+    File file = LittleFS.open(GRADIENT_PALETTE_FILE, "r");
+    std::vector<uint8> data(file.size());
+    file.read(data.data(), data.size());
+    file.close();
+
+    return data;
+}
+
+void writeFile(const std::vector<uint8> &data) {
+    File file = LittleFS.open(GRADIENT_PALETTE_FILE, "w");
+    file.write(data.data(), data.size());
+    file.close();
+}
+
+/**
+ * Checks the stored palette is refused, leaving no gradient.
+ */
+void assertNoPalette(const char *message) {
+    GradientPalette palette;
+    TEST_ASSERT_EQUAL_MESSAGE(0u, palette.openColors(), message);
+    palette.closeColors();
+    TEST_ASSERT_TRUE_MESSAGE(palette.service(true), message);
+    TEST_ASSERT_EQUAL_MESSAGE(0u, palette.getCount(), message);
+    TEST_ASSERT_NULL(palette.getGradient());
+}
+
+void setUp(void) {
+    LittleFS.format();
+    randomState = 1ul;
+}
+
+void tearDown(void) {}
+
+void testFullPaletteRoundTrip(void) {
+    GradientPalette palette;
+    std::vector<uint8> colors = randomColors(GRADIENT_PALETTE_MAX_COLORS);
+    savePalette(palette, colors);
+
+    TEST_ASSERT_EQUAL(GRADIENT_PALETTE_MAX_COLORS, palette.openColors());
+    std::vector<uint8> read;
+    uint8 chunk[GRADIENT_PALETTE_CHUNK_COLORS * 3u];
+    unsigned int count = 0u;
+    while ((count = palette.readColors(chunk, 7u)) > 0u) { // Not a whole chunk, to cross chunk edges
+        read.insert(read.end(), chunk, chunk + (count * 3u));
+    }
+    palette.closeColors();
+    TEST_ASSERT_EQUAL(colors.size(), read.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(colors.data(), read.data(), colors.size());
+
+    // One color to each step of the gradient, so it is the colors themselves
+    TEST_ASSERT_FALSE(palette.service(false)); // Not worked out until it is in use
+    TEST_ASSERT_NULL(palette.getGradient());
+    TEST_ASSERT_TRUE(palette.service(true));
+    TEST_ASSERT_FALSE(palette.service(true));
+    TEST_ASSERT_EQUAL(GRADIENT_PALETTE_MAX_COLORS, palette.getCount());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(colors.data(), palette.getGradient(), GRADIENT_SIZE * 3u);
+
+    TEST_ASSERT_FALSE(palette.beginSave(GRADIENT_PALETTE_MAX_COLORS + 1u, 0ul));
+    TEST_ASSERT_TRUE(palette.beginSave(0u, 0ul)); // Removes the palette
+    TEST_ASSERT_TRUE(palette.endSave());
+    TEST_ASSERT_FALSE(LittleFS.exists(GRADIENT_PALETTE_FILE));
+    TEST_ASSERT_TRUE(palette.service(false)); // Once worked out it follows every save
+    TEST_ASSERT_EQUAL(0u, palette.getCount());
+    TEST_ASSERT_NULL(palette.getGradient());
+}
+
+void testTruncatedFile(void) {
+    GradientPalette palette;
+    savePalette(palette, randomColors(40u));
+    std::vector<uint8> stored = readFile();
+    for (size_t length = 0u; length < stored.size(); length++) {
+        writeFile(std::vector<uint8>(stored.begin(), stored.begin() + length));
+        assertNoPalette("Truncated");
+    }
+    LittleFS.remove(GRADIENT_PALETTE_FILE);
+    assertNoPalette("No file");
+}
+
+void testBadCrc(void) {
+    GradientPalette palette;
+    std::vector<uint8> colors = randomColors(40u);
+    savePalette(palette, colors, Utils::crc32(colors.data(), colors.size()) ^ 0x01ul);
+    assertNoPalette("Saved with the wrong CRC");
+
+    savePalette(palette, colors);
+    std::vector<uint8> stored = readFile();
+    for (size_t i = 0u; i < stored.size(); i++) {
+        std::vector<uint8> damaged = stored;
+        damaged[i] ^= 0x01u;
+        writeFile(damaged);
+        assertNoPalette("A bit flipped");
+    }
+}
+
+void testGradientPassesThroughTheColors(void) {
+    const unsigned int counts[] = { 1u, 2u, 3u, 4u, 5u, 16u, 17u, 100u, 128u, 255u };
+    for (unsigned int count : counts) {
+        GradientPalette palette;
+        std::vector<uint8> colors = randomColors(count);
+        savePalette(palette, colors);
+        TEST_ASSERT_TRUE(palette.service(true));
+        TEST_ASSERT_EQUAL(count, palette.getCount());
+        const uint8 *gradient = palette.getGradient();
+        TEST_ASSERT_NOT_NULL(gradient);
+
+        char message[48];
+        snprintf(message, sizeof(message), "%u colors", count);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(&colors[0], &gradient[0], 3u, message); // Starts on the first
+        for (unsigned int i = 0u; i < count; i++) {
+            if ((i * GRADIENT_SIZE) % count == 0u) { // Lands on a step of the gradient
+                TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(&colors[i * 3u], &gradient[(i * GRADIENT_SIZE / count) * 3u], 3u, message);
+            }
+        }
+
+        // The last step blends from the last color back towards the first
+        const uint8 *last = &colors[(count - 1u) * 3u];
+        for (unsigned int c = 0u; c < 3u; c++) {
+            uint8 low = (last[c] < colors[c] ? last[c] : colors[c]);
+            uint8 high = (last[c] < colors[c] ? colors[c] : last[c]);
+            TEST_ASSERT_TRUE_MESSAGE(gradient[((GRADIENT_SIZE - 1u) * 3u) + c] >= low && gradient[((GRADIENT_SIZE - 1u) * 3u) + c] <= high, message);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testFullPaletteRoundTrip);
+    RUN_TEST(testTruncatedFile);
+    RUN_TEST(testBadCrc);
+    RUN_TEST(testGradientPassesThroughTheColors);
+
+    return UNITY_END();
+}
@@ -0,0 +1,232 @@
+/*
+  JsonReader - Walks documents of a fixed shape, nested objects and arrays
+  among them, and checks that every way of breaking one fails the read
+  rather than giving back part of it.
+*/
+
+#include <stdlib.h>
+#include <string>
+#include <unity.h>
+#include <JsonReader.h>
+
+#define DOCUMENT_MAX_ITEMS 4u
+
+const char VALID_DOCUMENT[] = "{\"n\":42,\"s\":\"text\",\"b\":true,\"z\":null,\"a\":[1,2,3],\"o\":{\"k\":\"v\",\"e\":[]}}";
+
+struct Document {
+    unsigned long    n                               ;
+    char             s       [8]                     ;
+    bool             b                               ;
+    unsigned long    a       [DOCUMENT_MAX_ITEMS]    ;
+    unsigned int     aCount                          ;
+    char             k       [4]                     ;
+};
+
+/**
+ * Reads a document of the shape of VALID_DOCUMENT, whose members may
+ * come in any order, the way the API handlers read their bodies.
+ */
+bool readDocument(const char *json, Document &document) {
+    memset(&document, 0, sizeof(document));
+    JsonReader reader(json);
+    char key[4];
+    if (!reader.beginObject()) {
+        return false;
+    }
+    while (reader.nextKey(key, sizeof(key))) {
+        bool ok = true;
+        if (strcmp(key, "n") == 0) {
+            ok = reader.readUnsigned(document.n);
+        } else if (strcmp(key, "s") == 0) {
+            ok = reader.readString(document.s, sizeof(document.s));
+        } else if (strcmp(key, "b") == 0) {
+            ok = reader.readBool(document.b);
+        } else if (strcmp(key, "z") == 0) {
+            ok = reader.readNull();
+        } else if (strcmp(key, "a") == 0) {
+            ok = reader.beginArray();
+            while (ok && reader.nextItem()) {
+                ok = document.aCount < DOCUMENT_MAX_ITEMS && reader.readUnsigned(document.a[document.aCount++]);
+            }
+        } else if (strcmp(key, "o") == 0) {
+            ok = reader.beginObject();
+            while (ok && reader.nextKey(key, sizeof(key))) {
+                if (strcmp(key, "k") == 0) {
+                    ok = reader.readString(document.k, sizeof(document.k));
+                } else if (strcmp(key, "e") == 0) {
+                    ok = reader.beginArray() && !reader.nextItem();
+                } else {
+                    ok = false;
+                }
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return reader.end();
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void testValidDocuments(void) {
+    Document document;
+    TEST_ASSERT_TRUE(readDocument(VALID_DOCUMENT, document));
+    TEST_ASSERT_EQUAL_UINT32(42ul, document.n);
+    TEST_ASSERT_EQUAL_STRING("text", document.s);
+    TEST_ASSERT_TRUE(document.b);
+    TEST_ASSERT_EQUAL_UINT(3u, document.aCount);
+    TEST_ASSERT_EQUAL_UINT32(3ul, document.a[2]);
+    TEST_ASSERT_EQUAL_STRING("v", document.k);
+
+    const char *VALID[] = {
+        "{}",
+        " \t\r\n{ \"o\" : { } , \"a\" : [ ] } \n",
+        "{\"o\":{\"e\":[],\"k\":\"\"},\"b\":false,\"a\":[0]}",
+        "{\"a\":[4294967295,0,7,10]}"
+    };
+    for (const char *json : VALID) {
+        TEST_ASSERT_TRUE_MESSAGE(readDocument(json, document), json);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4294967295ul, document.a[0]);
+}
+
+void testNestedArrays(void) {
+    JsonReader reader("[[1,2],[],[[3]],4]");
+    unsigned long value = 0ul, sum = 0ul;
+    TEST_ASSERT_TRUE(reader.beginArray());
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.beginArray());
+    while (reader.nextItem() && reader.readUnsigned(value)) {
+        sum += value;
+    }
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.beginArray());
+    TEST_ASSERT_FALSE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.beginArray());
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.beginArray());
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.readUnsigned(value));
+    sum += value;
+    TEST_ASSERT_FALSE(reader.nextItem());
+    TEST_ASSERT_FALSE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.readUnsigned(value));
+    sum += value;
+    TEST_ASSERT_FALSE(reader.nextItem());
+    TEST_ASSERT_TRUE(reader.end());
+    TEST_ASSERT_EQUAL_UINT32(10ul, sum);
+}
+
+void testMalformedDocuments(void) {
+    const char *MALFORMED[] = {
+        "",
+        " ",
+        "[]",
+        "{",
+        "}",
+        "{}}",
+        "{} x",
+        "{,}",
+        "{\"n\":1,}",
+        "{\"n\":1 \"b\":true}",
+        "{\"n\" 1}",
+        "{\"n\":}",
+        "{n:1}",
+        "{'n':1}",
+        "{\"n\":-1}",
+        "{\"n\":1.5}",
+        "{\"n\":0x10}",
+        "{\"n\":\"1\"}",
+        "{\"n\":99999999999999999999999}",
+        "{\"s\":\"unterminated}",
+        "{\"s\":\"esc\\\"aped\"}",
+        "{\"s\":\"too long\"}",
+        "{\"long\":1}",
+        "{\"b\":tru}",
+        "{\"b\":True}",
+        "{\"b\":1}",
+        "{\"z\":nul}",
+        "{\"z\":0}",
+        "{\"a\":[1,]}",
+        "{\"a\":[,1]}",
+        "{\"a\":[1 2]}",
+        "{\"a\":[1,2,3,4,5]}",
+        "{\"a\":[1}",
+        "{\"a\":{}}",
+        "{\"o\":{\"k\":\"v\"}",
+        "{\"o\":{\"k\":\"v\",}}",
+        "{\"o\":{\"e\":[1]}}",
+        "{\"o\":[]}",
+        "{\"x\":1}"
+    };
+    for (const char *json : MALFORMED) {
+        Document document;
+        TEST_ASSERT_FALSE_MESSAGE(readDocument(json, document), json);
+    }
+
+    JsonReader reader(nullptr);
+    TEST_ASSERT_TRUE(reader.hasFailed());
+    TEST_ASSERT_FALSE(reader.beginObject());
+    TEST_ASSERT_FALSE(reader.end());
+}
+
+void testFailureSticks(void) {
+    JsonReader reader("{\"n\":x,\"b\":true}");
+    char key[4];
+    unsigned long value = 0ul;
+    bool flag = false;
+    TEST_ASSERT_TRUE(reader.beginObject());
+    TEST_ASSERT_TRUE(reader.nextKey(key, sizeof(key)));
+    TEST_ASSERT_FALSE(reader.readUnsigned(value));
+    TEST_ASSERT_FALSE(reader.nextKey(key, sizeof(key)));
+    TEST_ASSERT_FALSE(reader.readBool(flag));
+    TEST_ASSERT_TRUE(reader.hasFailed());
+    TEST_ASSERT_FALSE(reader.end());
+}
+
+/*
+ * Every cut short copy of a valid document must fail, as must most
+ * copies with a byte changed. None may be read past its end.
+ */
+void testTruncatedAndMutated(void) {
+    std::string valid = VALID_DOCUMENT;
+    Document document;
+    for (size_t length = 0u; length < valid.size(); length++) {
+        std::string cut = valid.substr(0u, length);
+        TEST_ASSERT_FALSE_MESSAGE(readDocument(cut.c_str(), document), cut.c_str());
+    }
+
+    const char REPLACEMENTS[] = "{}[],:\" \\0123456789abcdefnstruel-";
+    srand(1234);
+    unsigned long accepted = 0ul;
+    for (unsigned int run = 0u; run < 20000u; run++) {
+        std::string mutated = valid;
+        for (unsigned int changes = 1u + (rand() % 3u); changes > 0u; changes--) {
+            mutated[rand() % mutated.size()] = REPLACEMENTS[rand() % (sizeof(REPLACEMENTS) - 1u)];
+        }
+        if (readDocument(mutated.c_str(), document)) {
+            accepted++; // Changes to a value may leave a valid document
+            TEST_ASSERT_LESS_OR_EQUAL(DOCUMENT_MAX_ITEMS, document.aCount);
+        }
+    }
+    TEST_ASSERT_LESS_THAN(20000ul / 2ul, accepted);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testValidDocuments);
+    RUN_TEST(testNestedArrays);
+    RUN_TEST(testMalformedDocuments);
+    RUN_TEST(testFailureSticks);
+    RUN_TEST(testTruncatedAndMutated);
+
+    return UNITY_END();
+}
@@ -0,0 +1,89 @@
+/*
+  PageWriter - Checks that what is written comes out whole and in order no
+  matter where it falls against the buffer, and that a chunk is only sent
+  each time the buffer fills.
+*/
+
+#include <string>
+#include <unity.h>
+#include <PageWriter.h>
+
+ESP8266WebServer server;
+
+void setUp(void) {
+    server.nativeReset();
+}
+
+void tearDown(void) {}
+
+void testBeginSendsHeadersOnly(void) {
+    PageWriter writer(server);
+    writer.begin(200, "text/html");
+    TEST_ASSERT_EQUAL_INT(200, server.responseCode);
+    TEST_ASSERT_EQUAL_size_t(CONTENT_LENGTH_UNKNOWN, server.contentLength);
+    TEST_ASSERT_EQUAL_size_t(0u, server.response.size());
+
+    writer.end();
+    TEST_ASSERT_EQUAL_UINT32(0ul, server.chunkCount);
+}
+
+void testNumbers(void) {
+    PageWriter writer(server);
+    writer.begin(200, "text/plain");
+    writer.write(0ul);
+    writer.write(',');
+    writer.write(7ul);
+    writer.write(',');
+    writer.write(4294967295ul);
+    writer.end();
+    TEST_ASSERT_EQUAL_STRING("0,7,4294967295", server.response.c_str());
+}
+
+void testChunksAcrossBufferBoundaries(void) {
+    static const char TEXT[] PROGMEM = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::string expected;
+    PageWriter writer(server);
+    writer.begin(200, "text/plain");
+    for (unsigned int i = 0u; i < 100u; i++) { // Lengths which don't divide the buffer
+        writer.write_P(TEXT, 1u + (i % 36u));
+        expected.append(TEXT, 1u + (i % 36u));
+        writer.write('|');
+        expected += '|';
+        writer.write("<>");
+        expected += "<>";
+        writer.write((unsigned long) i);
+        expected += std::to_string(i);
+    }
+    writer.write_P(TEXT);
+    expected += TEXT;
+    writer.end();
+
+    TEST_ASSERT_TRUE(server.response == expected);
+    TEST_ASSERT_EQUAL_UINT32((expected.size() + PAGE_WRITER_BUFFER_SIZE - 1u) / PAGE_WRITER_BUFFER_SIZE, server.chunkCount);
+}
+
+void testLargeProgmemWrite(void) {
+    static char page[PAGE_WRITER_BUFFER_SIZE * 3u + 17u];
+    for (unsigned int i = 0u; i < sizeof(page); i++) {
+        page[i] = 'a' + (i % 26u);
+    }
+    PageWriter writer(server);
+    writer.begin(200, "text/plain");
+    writer.write('>');
+    writer.write_P(page, sizeof(page));
+    writer.end();
+
+    TEST_ASSERT_EQUAL_size_t(sizeof(page) + 1u, server.response.size());
+    TEST_ASSERT_EQUAL_MEMORY(page, server.response.data() + 1u, sizeof(page));
+    TEST_ASSERT_EQUAL_UINT32(4ul, server.chunkCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testBeginSendsHeadersOnly);
+    RUN_TEST(testNumbers);
+    RUN_TEST(testChunksAcrossBufferBoundaries);
+    RUN_TEST(testLargeProgmemWrite);
+
+    return UNITY_END();
+}
@@ -0,0 +1,301 @@
+/*
+  PatternVm - Checks the chase program from the README draws the same frames
+  as the built in One Direction Chase, long after the step register wraps,
+  that arithmetic wraps rather than overflowing, that a runaway program is
+  cut off at its budget and that bad programs are refused.
+*/
+
+#include <unity.h>
+#include <Lighting.h>
+
+// The One Direction Chase program from the README
+const uint8 CHASE_PATTERN[] = {
+    0x0E, 0x05, 0x01, 0x00,
+    0x12, 0x05, 0x00, 0x05,
+    0x06, 0x06, 0x01, 0x04,
+    0x0E, 0x06, 0x06, 0x00,
+    0x07, 0x06, 0x06, 0x01,
+    0x01, 0x07, 0x01, 0x00,
+    0x20, 0x00, 0x06, 0x07
+};
+
+const uint64 CHASE_STEPS[] = {
+    0ull, 1ull, 10ull, 11ull, 599ull, 600ull,
+    32767ull, 32768ull, 32769ull, 65535ull, 65536ull,
+    1000003ull, 0x123456789ABull, 0xFFFFFFFFull, 0x100000000ull, 0xFFFFFFFFFFFFFFFFull
+};
+
+/*
+ * Checks that r10 == r11 once the program given has run, by
+ * lighting the pixel white only when they are equal.
+ */
+const uint8 CHECK_TAIL[] = {
+    0x01, 0x0C, 0x01, 0x00, // r12 = 1
+    0x12, 0x01, 0x0A, 0x0B, // Skip the next if r10 != r11
+    0x21, 0x0C, 0x0C, 0x0C, // White
+    0x00, 0x00, 0x00, 0x00
+};
+
+/*
+ * Loads INT32_MAX into r8 and INT32_MIN into r9, in raw 16.16 values,
+ * and 1/65536 into r13 and -1/65536 into r14.
+ */
+const uint8 LIMITS_HEAD[] = {
+    0x01, 0x08, 0xFF, 0x7F, // r8 = 32767
+    0x02, 0x0D, 0xFF, 0xFF, // r13 = 65535 / 65536
+    0x04, 0x08, 0x08, 0x0D, // r8 = INT32_MAX
+    0x01, 0x09, 0x00, 0x80, // r9 = -32768, INT32_MIN
+    0x02, 0x0D, 0x01, 0x00, // r13 = 1 / 65536
+    0x05, 0x0E, 0x0F, 0x0D  // r14 = 0 - r13
+};
+
+/**
+ * Runs the instructions given between LIMITS_HEAD and CHECK_TAIL
+ * for a single pixel.
+ *
+ * @return Returns true if r10 == r11 at the end.
+ */
+bool holds(const uint8 *body, unsigned int bodyLength, uint64 step = 0ull) {
+    uint8 program[PATTERN_MAX_INSTRUCTIONS * PATTERN_INSTRUCTION_SIZE];
+    unsigned int size = 0u;
+    memcpy(&program[size], LIMITS_HEAD, sizeof(LIMITS_HEAD));
+    size += sizeof(LIMITS_HEAD);
+    memcpy(&program[size], body, bodyLength * PATTERN_INSTRUCTION_SIZE);
+    size += bodyLength * PATTERN_INSTRUCTION_SIZE;
+    memcpy(&program[size], CHECK_TAIL, sizeof(CHECK_TAIL));
+    size += sizeof(CHECK_TAIL);
+
+    PatternVm vm;
+    TEST_ASSERT_TRUE(vm.setProgram(program, size / PATTERN_INSTRUCTION_SIZE));
+    uint8 pixel[3];
+    vm.run(pixel, 1u, step, 0u, nullptr, 0u);
+    TEST_ASSERT_EQUAL_UINT8(pixel[0], pixel[2]);
+
+    return pixel[0] == 255u;
+}
+
+void setUp(void) {
+    Native::setMicros(0ull);
+}
+
+void tearDown(void) {}
+
+void testChaseMatchesNativeEffect(void) {
+    const unsigned int lengths[] = { 1u, 2u, 11u, 150u, 600u };
+    TEST_ASSERT_TRUE(patternVm.setProgram(CHASE_PATTERN, sizeof(CHASE_PATTERN) / PATTERN_INSTRUCTION_SIZE));
+
+    Palette palette = { { CRGB(0xFF0000), CRGB(0x00FF00), CRGB(0x0000FF) }, 0u, nullptr };
+    static CRGB expected[MAX_LEDS];
+    static CRGB actual[MAX_LEDS];
+    for (unsigned int colors = 1u; colors <= MAX_COLORS; colors++) {
+        palette.size = colors;
+        for (unsigned int numLeds : lengths) {
+            for (uint64 step : CHASE_STEPS) {
+                FrameTime time = { step * 70000ull, step, 0x4000u };
+                oneDirectionChaseEffect.render(expected, numLeds, time, palette);
+                customPatternEffect.render(actual, numLeds, time, palette);
+                char message[80];
+                snprintf(message, sizeof(message), "%u LEDs, %u colors, step %llu", numLeds, colors, (unsigned long long) step);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE((uint8 *) expected, (uint8 *) actual, numLeds * sizeof(CRGB), message);
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0ul, patternVm.getOverBudgetFrames());
+}
+
+void testChaseNeverJumpsAcrossTheStepRegisterWrap(void) {
+    TEST_ASSERT_TRUE(patternVm.setProgram(CHASE_PATTERN, sizeof(CHASE_PATTERN) / PATTERN_INSTRUCTION_SIZE));
+    Palette palette = { { CRGB(0xFF0000), CRGB(0x00FF00), CRGB(0x0000FF) }, 3u, nullptr };
+    CRGB frame[11];
+    for (uint64 step = 32700ull; step < 32900ull; step++) {
+        customPatternEffect.render(frame, 11u, FrameTime{ 0ull, step, 0u }, palette);
+        for (unsigned int i = 0u; i < 11u; i++) {
+            bool lit = frame[i].r != 0u || frame[i].g != 0u || frame[i].b != 0u;
+            TEST_ASSERT_EQUAL(i == step % 11u, lit); // 32768 isn't a multiple of 11, so a wrap would show
+        }
+    }
+}
+
+void testStepRegisterWraps(void) {
+    const uint8 stepIsFive[] = {
+        0x03, 0x0A, 0x02, 0x00, // r10 = step
+        0x01, 0x0B, 0x05, 0x00  // r11 = 5
+    };
+    TEST_ASSERT_TRUE(holds(stepIsFive, 2u, 5ull));
+    TEST_ASSERT_TRUE(holds(stepIsFive, 2u, 32768ull + 5ull));
+    TEST_ASSERT_TRUE(holds(stepIsFive, 2u, 0x100000000ull + 5ull));
+    TEST_ASSERT_FALSE(holds(stepIsFive, 2u, 6ull));
+}
+
+void testStepModUsesTheWholeStep(void) {
+    const uint64 steps[] = { 999ull, 32768ull, 65536ull + 7ull, 0x123456789ABull, 0xFFFFFFFFFFFFFFFFull };
+    for (uint64 step : steps) {
+        uint16 expected = (uint16) (step % 1000ull);
+        const uint8 body[] = {
+            0x01, 0x05, 0xE8, 0x03, // r5 = 1000
+            0x0E, 0x0A, 0x05, 0x00, // r10 = step modulo r5
+            0x01, 0x0B, (uint8) expected, (uint8) (expected >> 8)
+        };
+        TEST_ASSERT_TRUE(holds(body, 3u, step));
+    }
+
+    const uint8 periodUnderOne[] = {
+        0x02, 0x05, 0xFF, 0xFF, // r5 = 65535 / 65536
+        0x0E, 0x0A, 0x05, 0x00,
+        0x01, 0x0B, 0x00, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(periodUnderOne, 3u, 12345ull));
+}
+
+void testArithmeticWraps(void) {
+    const uint8 addWraps[] = {
+        0x04, 0x0A, 0x08, 0x0D, // r10 = INT32_MAX + 1/65536
+        0x03, 0x0B, 0x09, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(addWraps, 2u));
+
+    const uint8 subWraps[] = {
+        0x05, 0x0A, 0x09, 0x0D, // r10 = INT32_MIN - 1/65536
+        0x03, 0x0B, 0x08, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(subWraps, 2u));
+
+    const uint8 mulWraps[] = {
+        0x01, 0x05, 0x00, 0x01, // r5 = 256
+        0x06, 0x0A, 0x05, 0x05, // r10 = 65536, which is 0 once wrapped
+        0x01, 0x0B, 0x00, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(mulWraps, 3u));
+
+    const uint8 divWraps[] = {
+        0x07, 0x0A, 0x08, 0x0D, // r10 = INT32_MAX * 65536, keeping the low 32 bits
+        0x01, 0x0B, 0xFF, 0xFF  // r11 = -1
+    };
+    TEST_ASSERT_TRUE(holds(divWraps, 2u));
+
+    const uint8 absOfMin[] = {
+        0x0C, 0x0A, 0x09, 0x00, // r10 = abs INT32_MIN, held at INT32_MAX
+        0x03, 0x0B, 0x08, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(absOfMin, 2u));
+}
+
+void testDivideAndModuloEdges(void) {
+    const uint8 divByZero[] = {
+        0x07, 0x0A, 0x08, 0x0F, // r10 = INT32_MAX / 0
+        0x01, 0x0B, 0x00, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(divByZero, 2u));
+
+    const uint8 modByZero[] = {
+        0x08, 0x0A, 0x08, 0x0F,
+        0x01, 0x0B, 0x00, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(modByZero, 2u));
+
+    const uint8 minModMinusOne[] = {
+        0x08, 0x0A, 0x09, 0x0E, // r10 = INT32_MIN modulo -1/65536, which traps if done directly
+        0x01, 0x0B, 0x00, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(minModMinusOne, 2u));
+
+    const uint8 negativeMod[] = {
+        0x01, 0x05, 0xFD, 0xFF, // r5 = -3
+        0x01, 0x06, 0x05, 0x00, // r6 = 5
+        0x08, 0x0A, 0x05, 0x06, // r10 = -3 modulo 5, from 0 up to 5
+        0x01, 0x0B, 0x02, 0x00
+    };
+    TEST_ASSERT_TRUE(holds(negativeMod, 4u));
+
+    const uint8 modNegative[] = {
+        0x01, 0x05, 0x03, 0x00, // r5 = 3
+        0x01, 0x06, 0xFB, 0xFF, // r6 = -5
+        0x08, 0x0A, 0x05, 0x06, // r10 = 3 modulo -5, from -5 up to 0
+        0x01, 0x0B, 0xFE, 0xFF
+    };
+    TEST_ASSERT_TRUE(holds(modNegative, 4u));
+}
+
+void testRunawayProgramIsCutOff(void) {
+    const uint8 program[] = {
+        0x01, 0x05, 0x01, 0x00, // r5 = 1
+        0x21, 0x05, 0x05, 0x05, // White
+        0x10, 0xFF, 0x00, 0x00  // Jump to itself
+    };
+    PatternVm vm;
+    TEST_ASSERT_TRUE(vm.setProgram(program, 3u));
+
+    uint8 pixels[10 * 3];
+    memset(pixels, 0xAA, sizeof(pixels));
+    vm.run(pixels, 10u, 0ull, 0u, nullptr, 0u);
+    TEST_ASSERT_EQUAL_UINT32(1ul, vm.getOverBudgetFrames());
+    TEST_ASSERT_EQUAL_UINT32(PATTERN_FRAME_BUDGET, vm.getLastInstructions());
+    for (unsigned int i = 0u; i < sizeof(pixels); i++) {
+        TEST_ASSERT_EQUAL_UINT8(0u, pixels[i]); // Even the pixel which was lit before the budget ran out
+    }
+
+    vm.run(pixels, 10u, 1ull, 0u, nullptr, 0u);
+    TEST_ASSERT_EQUAL_UINT32(2ul, vm.getOverBudgetFrames());
+}
+
+void testProgramWithinBudgetRunsWhole(void) {
+    PatternVm vm;
+    TEST_ASSERT_TRUE(vm.setProgram(CHASE_PATTERN, sizeof(CHASE_PATTERN) / PATTERN_INSTRUCTION_SIZE));
+    const uint8 colors[] = { 0x10, 0x20, 0x30 };
+    uint8 pixels[MAX_LEDS * 3];
+    vm.run(pixels, MAX_LEDS, 4ull, 0u, colors, 1u);
+    TEST_ASSERT_EQUAL_UINT32(0ul, vm.getOverBudgetFrames());
+    TEST_ASSERT_EQUAL_UINT32((MAX_LEDS * 2ul) + 5ul, vm.getLastInstructions()); // Two for each dark pixel, seven for the lit one
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(colors, &pixels[4 * 3], 3u);
+}
+
+void testBadProgramsAreRefused(void) {
+    PatternVm vm;
+    TEST_ASSERT_TRUE(vm.setProgram(CHASE_PATTERN, sizeof(CHASE_PATTERN) / PATTERN_INSTRUCTION_SIZE));
+
+    const uint8 unknownOp[] = { 0x0F, 0x00, 0x00, 0x00 };
+    const uint8 badDestination[] = { 0x03, 0x10, 0x00, 0x00 };
+    const uint8 badSource[] = { 0x04, 0x00, 0x00, 0x10 };
+    const uint8 badLoad[] = { 0x01, 0x10, 0x00, 0x00 };
+    const uint8 jumpPastEnd[] = { 0x10, 0x01, 0x00, 0x00 };
+    const uint8 jumpBeforeStart[] = { 0x00, 0x00, 0x00, 0x00, 0x11, 0xFD, 0x00, 0x00 };
+    const uint8 jumpBadRegister[] = { 0x13, 0x00, 0x00, 0x10 };
+    TEST_ASSERT_FALSE(vm.setProgram(unknownOp, 1u));
+    TEST_ASSERT_FALSE(vm.setProgram(badDestination, 1u));
+    TEST_ASSERT_FALSE(vm.setProgram(badSource, 1u));
+    TEST_ASSERT_FALSE(vm.setProgram(badLoad, 1u));
+    TEST_ASSERT_FALSE(vm.setProgram(jumpPastEnd, 1u));
+    TEST_ASSERT_FALSE(vm.setProgram(jumpBeforeStart, 2u));
+    TEST_ASSERT_FALSE(vm.setProgram(jumpBadRegister, 1u));
+
+    static uint8 tooLong[(PATTERN_MAX_INSTRUCTIONS + 1u) * PATTERN_INSTRUCTION_SIZE];
+    memset(tooLong, 0, sizeof(tooLong));
+    TEST_ASSERT_FALSE(vm.setProgram(tooLong, PATTERN_MAX_INSTRUCTIONS + 1u));
+    TEST_ASSERT_TRUE(vm.setProgram(tooLong, PATTERN_MAX_INSTRUCTIONS));
+
+    // The program refused leaves the one before it in place
+    TEST_ASSERT_EQUAL(PATTERN_MAX_INSTRUCTIONS, vm.getLength());
+    TEST_ASSERT_FALSE(vm.setProgram(unknownOp, 1u));
+    TEST_ASSERT_EQUAL(PATTERN_MAX_INSTRUCTIONS, vm.getLength());
+
+    // Jumps may land on the end, finishing the pixel, or on the start
+    const uint8 jumpToEnd[] = { 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8 jumpToStart[] = { 0x00, 0x00, 0x00, 0x00, 0x14, 0xFE, 0x0F, 0x0F };
+    TEST_ASSERT_TRUE(vm.setProgram(jumpToEnd, 2u));
+    TEST_ASSERT_TRUE(vm.setProgram(jumpToStart, 2u));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testChaseMatchesNativeEffect);
+    RUN_TEST(testChaseNeverJumpsAcrossTheStepRegisterWrap);
+    RUN_TEST(testStepRegisterWraps);
+    RUN_TEST(testStepModUsesTheWholeStep);
+    RUN_TEST(testArithmeticWraps);
+    RUN_TEST(testDivideAndModuloEdges);
+    RUN_TEST(testRunawayProgramIsCutOff);
+    RUN_TEST(testProgramWithinBudgetRunsWhole);
+    RUN_TEST(testBadProgramsAreRefused);
+
+    return UNITY_END();
+}
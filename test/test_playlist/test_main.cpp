@@ -0,0 +1,157 @@
+/*
+  Playlist - Checks that a playlist round trips through LittleFS, that a
+  damaged file is refused, and that a file with a valid CRC is still refused
+  as a whole when any entry holds a value PUT /api/playlist wouldn't accept.
+  Also steps through a playlist to check each look is shown for its time.
+*/
+
+#include <vector>
+#include <unity.h>
+#include <Playlist.h>
+
+#define EFFECT_COUNT 8u
+#define MAX_STEP_MICROS 60000000ul
+
+const PlaylistEntry ENTRIES[] = {
+    { 3u, 1u, { { 0xFFu, 0x00u, 0x00u } }, 0u, 50000ul, 10u, 1000u },
+    { 0u, 3u, { { 0x01u, 0x02u, 0x03u }, { 0x04u, 0x05u, 0x06u }, { 0x07u, 0x08u, 0x09u } }, 0u, 0ul, 1u, 0u },
+    { EFFECT_COUNT - 1u, 2u, { { 0x10u, 0x20u, 0x30u }, { 0x40u, 0x50u, 0x60u } }, 0u, MAX_STEP_MICROS, 0xFFFFu, 0xFFFFu }
+};
+const unsigned int ENTRY_COUNT = sizeof(ENTRIES) / sizeof(ENTRIES[0]);
+
+std::vector<uint8_t> readFile() {
+    File file = LittleFS.open(PLAYLIST_FILE, "r");
+    std::vector<uint8_t> data(file.size());
+    file.read(data.data(), data.size());
+    file.close();
+
+    return data;
+}
+
+void writeFile(const std::vector<uint8_t> &data) {
+    File file = LittleFS.open(PLAYLIST_FILE, "w");
+    file.write(data.data(), data.size());
+    file.close();
+}
+
+/**
+ * Saves the given entries, playing, as the stored playlist.
+ */
+void saveEntries(const PlaylistEntry *entries, unsigned int count) {
+    Playlist playlist;
+    TEST_ASSERT_TRUE(playlist.setEntries(entries, count));
+    playlist.play();
+    TEST_ASSERT_TRUE(playlist.save());
+}
+
+/**
+ * Checks the stored playlist is refused and leaves the playlist empty.
+ */
+void assertRefused(const char *message) {
+    Playlist playlist;
+    TEST_ASSERT_FALSE_MESSAGE(playlist.load(EFFECT_COUNT, MAX_STEP_MICROS), message);
+    TEST_ASSERT_EQUAL_MESSAGE(0u, playlist.getCount(), message);
+    TEST_ASSERT_FALSE_MESSAGE(playlist.isPlaying(), message);
+}
+
+void setUp(void) {
+    LittleFS.format();
+}
+
+void tearDown(void) {}
+
+void testRoundTrip(void) {
+    saveEntries(ENTRIES, ENTRY_COUNT);
+
+    Playlist playlist;
+    TEST_ASSERT_TRUE(playlist.load(EFFECT_COUNT, MAX_STEP_MICROS));
+    TEST_ASSERT_EQUAL(ENTRY_COUNT, playlist.getCount());
+    TEST_ASSERT_TRUE(playlist.isPlaying());
+    for (unsigned int i = 0u; i < ENTRY_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(&ENTRIES[i], playlist.getEntry(i), sizeof(PlaylistEntry));
+    }
+    TEST_ASSERT_NULL(playlist.getEntry(ENTRY_COUNT));
+
+    playlist.stop();
+    TEST_ASSERT_TRUE(playlist.save());
+    Playlist stopped;
+    TEST_ASSERT_TRUE(stopped.load(EFFECT_COUNT, MAX_STEP_MICROS));
+    TEST_ASSERT_FALSE(stopped.isPlaying());
+
+    TEST_ASSERT_TRUE(stopped.setEntries(ENTRIES, 0u)); // An empty playlist is still a playlist
+    TEST_ASSERT_TRUE(stopped.save());
+    TEST_ASSERT_TRUE(playlist.load(EFFECT_COUNT, MAX_STEP_MICROS));
+    TEST_ASSERT_EQUAL(0u, playlist.getCount());
+}
+
+void testDamagedFiles(void) {
+    assertRefused("No file");
+
+    saveEntries(ENTRIES, ENTRY_COUNT);
+    std::vector<uint8_t> stored = readFile();
+    for (size_t length = 0u; length < stored.size(); length++) {
+        writeFile(std::vector<uint8_t>(stored.begin(), stored.begin() + length));
+        assertRefused("Truncated");
+    }
+    for (size_t i = 0u; i < stored.size(); i++) {
+        if (i == 6u) { // The flags are outside the CRC
+            continue;
+        }
+        std::vector<uint8_t> damaged = stored;
+        damaged[i] ^= 0x01u;
+        writeFile(damaged);
+        assertRefused("A bit flipped");
+    }
+}
+
+void testInvalidEntriesRefuseTheFile(void) {
+    const struct {
+        const char *message;
+        void (*damage)(PlaylistEntry &entry);
+    } cases[] = {
+        { "Unknown effect", [](PlaylistEntry &entry) { entry.effectId = EFFECT_COUNT; } },
+        { "No colors", [](PlaylistEntry &entry) { entry.colorsSize = 0u; } },
+        { "Too many colors", [](PlaylistEntry &entry) { entry.colorsSize = PLAYLIST_MAX_COLORS + 1u; } },
+        { "Reserved set", [](PlaylistEntry &entry) { entry.reserved = 1u; } },
+        { "Step too long", [](PlaylistEntry &entry) { entry.stepMicros = MAX_STEP_MICROS + 1ul; } },
+        { "Never shown", [](PlaylistEntry &entry) { entry.seconds = 0u; } }
+    };
+    for (const auto &damageCase : cases) {
+        for (unsigned int i = 0u; i < ENTRY_COUNT; i++) {
+            PlaylistEntry entries[ENTRY_COUNT];
+            memcpy(entries, ENTRIES, sizeof(entries));
+            damageCase.damage(entries[i]);
+            TEST_ASSERT_FALSE_MESSAGE(Playlist::isValidEntry(entries[i], EFFECT_COUNT, MAX_STEP_MICROS), damageCase.message);
+            saveEntries(entries, ENTRY_COUNT);
+            assertRefused(damageCase.message);
+        }
+    }
+}
+
+void testService(void) {
+    Playlist playlist;
+    TEST_ASSERT_TRUE(playlist.setEntries(ENTRIES, 2u));
+    TEST_ASSERT_NULL(playlist.service(0ul)); // Not playing
+
+    playlist.play();
+    TEST_ASSERT_EQUAL_PTR(playlist.getEntry(0u), playlist.service(1000ul));
+    TEST_ASSERT_NULL(playlist.service(1000ul + 9999ul));
+    TEST_ASSERT_EQUAL_PTR(playlist.getEntry(1u), playlist.service(1000ul + 10000ul));
+    TEST_ASSERT_NULL(playlist.service(11000ul + 999ul));
+    TEST_ASSERT_EQUAL_PTR(playlist.getEntry(0u), playlist.service(11000ul + 1000ul)); // Round again
+    TEST_ASSERT_EQUAL(0u, playlist.getCurrent());
+
+    TEST_ASSERT_TRUE(playlist.setEntries(ENTRIES, 0u));
+    TEST_ASSERT_FALSE(playlist.isPlaying());
+    TEST_ASSERT_FALSE(playlist.setEntries(ENTRIES, PLAYLIST_MAX_ENTRIES + 1u));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testRoundTrip);
+    RUN_TEST(testDamagedFiles);
+    RUN_TEST(testInvalidEntriesRefuseTheFile);
+    RUN_TEST(testService);
+
+    return UNITY_END();
+}
@@ -0,0 +1,246 @@
+/*
+  Settings - Checks the binary settings record against the in-memory
+  EEPROM: that it round trips, that a damaged record is refused, and that
+  records written by older firmware are migrated.
+*/
+
+#include <unity.h>
+#include <Settings.h>
+
+// Where the header fields sit in a stored record
+#define RECORD_VERSION_OFFSET 4u
+#define RECORD_LENGTH_OFFSET 6u
+#define RECORD_CRC_OFFSET 8u
+#define RECORD_CRC_START 12u
+#define RECORD_V2_LENGTH 32u // Up to the padding
+#define RECORD_V3_LENGTH 36u // Up to actionDelayMicros
+
+/*
+ * The older layouts as Settings declares them, built here as older
+ * firmware would have stored them.
+ */
+struct NVSettingsV1 {
+    uint32           magic                                       ;
+    uint8            version                                     ;
+    uint8            actionId                                    ;
+    uint8            colorsSize                                  ;
+    uint8            reserved                                    ;
+    uint32           actionDelay                                 ;
+    uint8            colors         [MAX_SETTINGS_COLORS][3]     ;
+    uint8            padding        [3]                          ;
+    uint32           crc                                         ;
+};
+
+struct LegacyNVSettings {
+    char             actionName     [100]    ;
+    unsigned long    actionDelay             ;
+    char             colors         [100]    ;
+    unsigned int     colorsSize              ;
+    char             sentinel       [33]     ;
+};
+
+void setUp(void) {
+    EEPROM.nativeReset();
+}
+
+void tearDown(void) {}
+
+/**
+ * Saves settings which differ from the factory ones in every field
+ * and gives back the record stored.
+ */
+void saveCustomSettings(uint8 *record) {
+    Settings settings;
+    settings.setActionId(4u);
+    settings.setActionDelayMicros(250000ul);
+    settings.setColor(0u, 0x102030ul);
+    settings.setColor(1u, 0x405060ul);
+    settings.setColorsSize(2u);
+    settings.setLedCount(300u);
+    settings.setDataPin(2u);
+    settings.setColorOrder(5u);
+    settings.setSyncRole(2u);
+    settings.setSyncLeaderId("ABC123");
+    TEST_ASSERT_TRUE(settings.saveSettings());
+    memcpy(record, EEPROM.nativeStored(), SETTINGS_STORAGE_SIZE);
+}
+
+void setRecordHeader(uint8 *record, uint8 version, uint16 length) {
+    record[RECORD_VERSION_OFFSET] = version;
+    memcpy(&record[RECORD_LENGTH_OFFSET], &length, sizeof(length));
+    uint32 crc = Utils::crc32(&record[RECORD_CRC_START], length - RECORD_CRC_START);
+    memcpy(&record[RECORD_CRC_OFFSET], &crc, sizeof(crc));
+}
+
+void assertFactorySettings(Settings &settings) {
+    TEST_ASSERT_EQUAL_UINT8(2u, settings.getActionId());
+    TEST_ASSERT_EQUAL_UINT32(70000ul, settings.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_UINT(1u, settings.getColorsSize());
+    TEST_ASSERT_EQUAL_HEX32(0x0000FFul, settings.getColor(0u));
+    TEST_ASSERT_EQUAL_UINT(11u, settings.getLedCount());
+    TEST_ASSERT_EQUAL_UINT8(0u, settings.getSyncRole());
+}
+
+void testCrc32(void) {
+    const uint8 *check = (const uint8 *) "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0x00000000ul, Utils::crc32(check, 0u));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926ul, Utils::crc32(check, 9u));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926ul, Utils::crc32(&check[4], 5u, Utils::crc32(check, 4u)));
+
+    const uint8 zeros[4] = {0u, 0u, 0u, 0u};
+    TEST_ASSERT_EQUAL_HEX32(0x2144DF1Cul, Utils::crc32(zeros, 4u));
+}
+
+void testFactoryDefaultWhenEmpty(void) {
+    Settings settings;
+    TEST_ASSERT_FALSE(settings.loadSettings());
+    assertFactorySettings(settings);
+    TEST_ASSERT_EQUAL_UINT32(1ul, EEPROM.nativeCommits());
+
+    Settings reloaded;
+    TEST_ASSERT_TRUE(reloaded.loadSettings());
+    assertFactorySettings(reloaded);
+}
+
+void testRoundTrip(void) {
+    uint8 record[SETTINGS_STORAGE_SIZE];
+    saveCustomSettings(record);
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_UINT8(4u, settings.getActionId());
+    TEST_ASSERT_EQUAL_UINT32(250000ul, settings.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_UINT(2u, settings.getColorsSize());
+    TEST_ASSERT_EQUAL_HEX32(0x102030ul, settings.getColor(0u));
+    TEST_ASSERT_EQUAL_HEX32(0x405060ul, settings.getColor(1u));
+    TEST_ASSERT_EQUAL_UINT(300u, settings.getLedCount());
+    TEST_ASSERT_EQUAL_UINT8(2u, settings.getDataPin());
+    TEST_ASSERT_EQUAL_UINT8(5u, settings.getColorOrder());
+    TEST_ASSERT_EQUAL_UINT8(2u, settings.getSyncRole());
+    TEST_ASSERT_EQUAL_STRING("ABC123", settings.getSyncLeaderId());
+
+    // Loaded settings are already in flash, saving them again writes nothing
+    unsigned long commits = EEPROM.nativeCommits();
+    TEST_ASSERT_TRUE(settings.saveSettings());
+    TEST_ASSERT_EQUAL_UINT32(commits, EEPROM.nativeCommits());
+}
+
+void testDamagedRecordRefused(void) {
+    uint8 record[SETTINGS_STORAGE_SIZE];
+    saveCustomSettings(record);
+    for (unsigned int i = 0u; i < SETTINGS_STORAGE_SIZE - 4u; i++) { // The last bytes are past the record
+        if (i == RECORD_VERSION_OFFSET || i == RECORD_VERSION_OFFSET + 1u) {
+            continue; // A newer version is read as far as it is known, and reserved is free to change
+        }
+        uint8 damaged[SETTINGS_STORAGE_SIZE];
+        memcpy(damaged, record, sizeof(damaged));
+        damaged[i] ^= 0x01u;
+        EEPROM.nativeReset();
+        EEPROM.nativeStore(damaged, sizeof(damaged));
+
+        Settings settings;
+        char message[32];
+        snprintf(message, sizeof(message), "byte %u", i);
+        TEST_ASSERT_FALSE_MESSAGE(settings.loadSettings(), message);
+        assertFactorySettings(settings);
+    }
+}
+
+void testVersion2And3Records(void) {
+    uint8 record[SETTINGS_STORAGE_SIZE];
+    saveCustomSettings(record);
+    memset(&record[RECORD_V3_LENGTH], 0x11u, SETTINGS_STORAGE_SIZE - RECORD_V3_LENGTH); // Past the end of a version 3 record
+    setRecordHeader(record, 3u, RECORD_V3_LENGTH);
+    EEPROM.nativeStore(record, sizeof(record));
+    Settings v3;
+    TEST_ASSERT_TRUE(v3.loadSettings());
+    TEST_ASSERT_EQUAL_UINT32(250000ul, v3.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_UINT(300u, v3.getLedCount());
+    TEST_ASSERT_EQUAL_UINT8(0u, v3.getSyncRole());
+    TEST_ASSERT_EQUAL_STRING("", v3.getSyncLeaderId());
+
+    memset(&record[RECORD_V2_LENGTH], 0x11u, SETTINGS_STORAGE_SIZE - RECORD_V2_LENGTH); // Version 2 only had the delay in millis
+    setRecordHeader(record, 2u, RECORD_V2_LENGTH);
+    EEPROM.nativeReset();
+    EEPROM.nativeStore(record, sizeof(record));
+    Settings v2;
+    TEST_ASSERT_TRUE(v2.loadSettings());
+    TEST_ASSERT_EQUAL_UINT8(4u, v2.getActionId());
+    TEST_ASSERT_EQUAL_UINT32(250000ul, v2.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_HEX32(0x405060ul, v2.getColor(1u));
+    TEST_ASSERT_EQUAL_UINT8(0u, v2.getSyncRole());
+}
+
+void testVersion1Migration(void) {
+    NVSettingsV1 v1;
+    memset(&v1, 0, sizeof(v1));
+    v1.magic = SETTINGS_MAGIC;
+    v1.version = 1u;
+    v1.actionId = 3u;
+    v1.colorsSize = 3u;
+    v1.actionDelay = 120ul;
+    const uint8 colors[MAX_SETTINGS_COLORS][3] = {{0xFF, 0x00, 0x00}, {0x00, 0xFF, 0x00}, {0x00, 0x00, 0xFF}};
+    memcpy(v1.colors, colors, sizeof(colors));
+    v1.crc = Utils::crc32((const uint8 *) &v1, offsetof(NVSettingsV1, crc));
+    EEPROM.nativeStore(&v1, sizeof(v1));
+
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_UINT8(3u, settings.getActionId());
+    TEST_ASSERT_EQUAL_UINT32(120000ul, settings.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_UINT(3u, settings.getColorsSize());
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00ul, settings.getColor(1u));
+    TEST_ASSERT_EQUAL_UINT(11u, settings.getLedCount());
+
+    // Migrated settings are saved in the current layout
+    Settings reloaded;
+    TEST_ASSERT_TRUE(reloaded.loadSettings());
+    TEST_ASSERT_EQUAL_HEX32(0x0000FFul, reloaded.getColor(2u));
+    TEST_ASSERT_EQUAL_UINT8(SETTINGS_VERSION, EEPROM.nativeStored()[RECORD_VERSION_OFFSET]);
+
+    v1.actionId = 4u; // Without updating the CRC
+    EEPROM.nativeReset();
+    EEPROM.nativeStore(&v1, sizeof(v1));
+    Settings damaged;
+    TEST_ASSERT_FALSE(damaged.loadSettings());
+    assertFactorySettings(damaged);
+}
+
+void testLegacyMigration(void) {
+    LegacyNVSettings legacy;
+    memset(&legacy, 0, sizeof(legacy));
+    strcpy(legacy.actionName, "backAndForthChase");
+    legacy.actionDelay = 45ul;
+    strcpy(legacy.colors, "ff8000:0080ff");
+    legacy.colorsSize = 2u;
+    String content = String(legacy.actionName) + String(legacy.actionDelay) + String(legacy.colors) + String(legacy.colorsSize);
+    strcpy(legacy.sentinel, Utils::hashString(content).c_str());
+    EEPROM.nativeStore(&legacy, sizeof(legacy));
+
+    Settings settings;
+    TEST_ASSERT_TRUE(settings.loadSettings());
+    TEST_ASSERT_EQUAL_UINT8(4u, settings.getActionId());
+    TEST_ASSERT_EQUAL_UINT32(45000ul, settings.getActionDelayMicros());
+    TEST_ASSERT_EQUAL_UINT(2u, settings.getColorsSize());
+    TEST_ASSERT_EQUAL_HEX32(0xFF8000ul, settings.getColor(0u));
+    TEST_ASSERT_EQUAL_HEX32(0x0080FFul, settings.getColor(1u));
+
+    legacy.sentinel[0] = (legacy.sentinel[0] == '0' ? '1' : '0');
+    EEPROM.nativeReset();
+    EEPROM.nativeStore(&legacy, sizeof(legacy));
+    Settings damaged;
+    TEST_ASSERT_FALSE(damaged.loadSettings());
+    assertFactorySettings(damaged);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testCrc32);
+    RUN_TEST(testFactoryDefaultWhenEmpty);
+    RUN_TEST(testRoundTrip);
+    RUN_TEST(testDamagedRecordRefused);
+    RUN_TEST(testVersion2And3Records);
+    RUN_TEST(testVersion1Migration);
+    RUN_TEST(testLegacyMigration);
+
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+/*
+  Settings wear - Plays a scripted run of someone using the control page
+  against the in-memory ESP_EEPROM and counts the flash erases, saving
+  each change straight away as the firmware once did and then coalescing
+  them as it does now.
+*/
+
+#include <unity.h>
+#include <Settings.h>
+
+#define WEAR_BURSTS 50u // Times the page is used
+#define WEAR_CHANGES_PER_BURST 40u // Changes made while dragging a slider
+#define WEAR_CHANGE_INTERVAL_MILLIS 100ul
+#define WEAR_PAUSE_MILLIS 30000ul // Between bursts
+
+void setUp(void) {
+    EEPROM.nativeReset();
+    Native::setMicros(0ull);
+}
+
+void tearDown(void) {}
+
+void report(const char *name, unsigned long changes) {
+    char message[96];
+    snprintf(message, sizeof(message), "%-12s %5lu changes %5lu writes %4lu erases", name, changes, EEPROM.nativeCommits(), EEPROM.nativeErases());
+    TEST_MESSAGE(message);
+}
+
+/**
+ * Wipes the sector and commits on every change, as saving did before
+ * writes were coalesced.
+ */
+void testWipeOnEveryChange(void) {
+    unsigned long changes = 0ul;
+    for (unsigned int burst = 0u; burst < WEAR_BURSTS; burst++) {
+        for (unsigned int change = 0u; change < WEAR_CHANGES_PER_BURST; change++) {
+            uint8 record[SETTINGS_STORAGE_SIZE];
+            memset(record, (uint8) changes, sizeof(record));
+            EEPROM.begin(SETTINGS_STORAGE_SIZE);
+            EEPROM.wipe();
+            EEPROM.put(0, record);
+            EEPROM.commit();
+            EEPROM.end();
+            changes++;
+        }
+    }
+    report("wipe", changes);
+    TEST_ASSERT_EQUAL_UINT32(changes, EEPROM.nativeErases());
+}
+
+void testCoalescedSaves(void) {
+    Settings settings;
+    settings.loadSettings();
+    unsigned long changes = 0ul;
+    for (unsigned int burst = 0u; burst < WEAR_BURSTS; burst++) {
+        for (unsigned int change = 0u; change < WEAR_CHANGES_PER_BURST; change++) {
+            settings.setActionDelayMicros(1000ul + changes);
+            settings.requestSave();
+            changes++;
+            Native::advanceMicros(WEAR_CHANGE_INTERVAL_MILLIS * 1000ull);
+            TEST_ASSERT_FALSE(settings.service());
+        }
+        for (unsigned long waited = 0ul; waited < WEAR_PAUSE_MILLIS; waited += WEAR_CHANGE_INTERVAL_MILLIS) {
+            settings.service();
+            Native::advanceMicros(WEAR_CHANGE_INTERVAL_MILLIS * 1000ull);
+        }
+    }
+    report("coalesced", changes);
+
+    // One write for the factory settings at first boot and one per burst
+    TEST_ASSERT_EQUAL_UINT32(1ul + WEAR_BURSTS, EEPROM.nativeCommits());
+    TEST_ASSERT_EQUAL_UINT32(1ul + WEAR_BURSTS, settings.getSaveCount());
+    TEST_ASSERT_EQUAL_UINT32(0ul, EEPROM.nativeErases());
+
+    Settings reloaded;
+    TEST_ASSERT_TRUE(reloaded.loadSettings());
+    TEST_ASSERT_EQUAL_UINT32(1000ul + changes - 1ul, reloaded.getActionDelayMicros());
+}
+
+void testSavesPerErase(void) {
+    Settings settings;
+    settings.loadSettings();
+    unsigned int slots = EEPROMClass::slotCount(SETTINGS_STORAGE_SIZE);
+    for (unsigned long save = 0ul; save < slots * 10ul; save++) {
+        settings.setActionDelayMicros(save);
+        TEST_ASSERT_TRUE(settings.saveSettings());
+    }
+    report("every save", slots * 10ul);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(80u, slots);
+    TEST_ASSERT_EQUAL_UINT32((EEPROM.nativeCommits() - 1ul) / slots, EEPROM.nativeErases()); // The sector starts out erased
+
+    // Saving settings which haven't changed writes nothing
+    unsigned long commits = EEPROM.nativeCommits();
+    for (unsigned int save = 0u; save < 100u; save++) {
+        TEST_ASSERT_TRUE(settings.saveSettings());
+    }
+    TEST_ASSERT_EQUAL_UINT32(commits, EEPROM.nativeCommits());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testWipeOnEveryChange);
+    RUN_TEST(testCoalescedSaves);
+    RUN_TEST(testSavesPerErase);
+
+    return UNITY_END();
+}
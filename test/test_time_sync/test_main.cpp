@@ -0,0 +1,179 @@
+/*
+  TimeSync - Checks the beacon format, then plays a leader's beacons to a
+  follower over a network which delays them by varying amounts, loses some
+  and reorders others, while the two clocks drift apart. The follower must
+  never run ahead of the leader and must stay within a few millis of it, on
+  a LAN within a milli more than the quickest delivery takes.
+*/
+
+#include <unity.h>
+#include <TimeSync.h>
+
+#define LEADER_START_MICROS 5000000000ull // The leader has been up longer
+#define MIN_DELAY_MICROS 1000ull
+#define MAX_JITTER_MICROS 20000ull
+#define LAN_MIN_DELAY_MICROS 200ull
+#define LAN_MAX_JITTER_MICROS 2000ull
+#define BEACONS 2000u // Over eight minutes
+
+uint32_t randomState = 1u;
+
+uint32_t nextRandom() {
+    randomState = (randomState * 1103515245u) + 12345u;
+
+    return randomState >> 8;
+}
+
+struct Delivery {
+    uint8_t      packet      [TIME_SYNC_BEACON_SIZE]     ;
+    uint64_t     arrival                                 ; // Local time
+};
+
+void setUp(void) {
+    randomState = 1u;
+}
+
+void tearDown(void) {}
+
+void testBeaconFormat(void) {
+    uint8_t packet[TIME_SYNC_BEACON_SIZE];
+    TEST_ASSERT_EQUAL_size_t(TIME_SYNC_BEACON_SIZE, TimeSync::writeBeacon(0x04030201ul, 0x0C0B0A0908070605ull, packet));
+    const uint8_t GOLDEN[TIME_SYNC_BEACON_SIZE] = {
+        0x53, 0x59, 0x4E, 0x43, // "SYNC"
+        TIME_SYNC_VERSION,
+        0x01, 0x02, 0x03, 0x04,
+        0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C
+    };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(GOLDEN, packet, TIME_SYNC_BEACON_SIZE);
+
+    TimeSync sync;
+    TEST_ASSERT_FALSE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE - 1u, 0ull));
+    packet[4] = TIME_SYNC_VERSION + 1u;
+    TEST_ASSERT_FALSE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, 0ull));
+    packet[4] = TIME_SYNC_VERSION;
+    packet[0] ^= 0x01u;
+    TEST_ASSERT_FALSE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, 0ull));
+    TEST_ASSERT_FALSE(sync.isLocked(0ull));
+    packet[0] ^= 0x01u;
+    TEST_ASSERT_TRUE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, 5ull));
+    TEST_ASSERT_TRUE(sync.isLocked(5ull));
+    TEST_ASSERT_EQUAL_INT64(0x0C0B0A0908070600ll, sync.getOffsetMicros());
+}
+
+/**
+ * Runs the follower against a leader whose clock gains the given parts
+ * per million on the follower's, over a network which delays each beacon
+ * by the given minimum plus up to the given jitter. Once settled the
+ * follower must be behind the leader by no more than the given error.
+ */
+void runFollower(int64_t driftPpm, uint64_t minDelay, uint64_t maxJitter, int64_t maxError) {
+    TimeSync sync;
+    Delivery held; // A beacon being held back to arrive after the next
+    bool holding = false;
+    unsigned long lost = 0ul;
+    unsigned long overtaken = 0ul;
+    uint64_t lastLeaderTime = 0ull;
+    int64_t worstError = 0ll;
+    for (unsigned int beacon = 1u; beacon <= BEACONS; beacon++) {
+        uint64_t sent = 2000000ull + (beacon * TIME_SYNC_INTERVAL_MICROS); // Local time
+        uint64_t leaderMicros = LEADER_START_MICROS + sent + ((int64_t) sent * driftPpm / 1000000ll);
+        if (nextRandom() % 100u < 20u) { // Lost
+            lost++;
+            continue;
+        }
+
+        Delivery delivery;
+        TimeSync::writeBeacon(beacon, leaderMicros, delivery.packet);
+        delivery.arrival = sent + minDelay + (nextRandom() % maxJitter);
+        if (!holding && nextRandom() % 100u < 5u) {
+            held = delivery;
+            holding = true;
+            continue;
+        }
+        TEST_ASSERT_TRUE(sync.readBeacon(delivery.packet, TIME_SYNC_BEACON_SIZE, delivery.arrival));
+        if (holding) { // Overtaken by this one
+            TEST_ASSERT_TRUE(sync.readBeacon(held.packet, TIME_SYNC_BEACON_SIZE, delivery.arrival + 10ull));
+            holding = false;
+            overtaken++;
+        }
+
+        // Check the leader's time as the follower works it out midway to the next beacon
+        uint64_t local = delivery.arrival + (TIME_SYNC_INTERVAL_MICROS / 2ull);
+        uint64_t trueLeader = LEADER_START_MICROS + local + ((int64_t) local * driftPpm / 1000000ll);
+        uint64_t leaderTime = sync.toLeaderTime(local);
+        TEST_ASSERT_TRUE(sync.isLocked(local));
+        TEST_ASSERT_TRUE(leaderTime >= lastLeaderTime);
+        TEST_ASSERT_TRUE(leaderTime < trueLeader); // Beacons are only ever late
+        lastLeaderTime = leaderTime;
+        if (beacon > 40u && (int64_t) (trueLeader - leaderTime) > worstError) {
+            worstError = trueLeader - leaderTime;
+        }
+    }
+    if (holding) { // Nothing came after it, so it arrives in order
+        TEST_ASSERT_TRUE(sync.readBeacon(held.packet, TIME_SYNC_BEACON_SIZE, held.arrival));
+        holding = false;
+    }
+
+    char message[112];
+    snprintf(message, sizeof(message), "drift %lld ppm, jitter up to %llu us: worst error %lld us, jitter %lu us", (long long) driftPpm, (unsigned long long) maxJitter, (long long) worstError, sync.getJitterMicros());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(worstError <= maxError);
+    TEST_ASSERT_TRUE(sync.getJitterMicros() < maxJitter);
+    // A beacon overtaken by the next is of no use once it arrives, so it counts as lost
+    TEST_ASSERT_EQUAL_UINT32(lost + overtaken, sync.getLostBeacons());
+    TEST_ASSERT_EQUAL_UINT32(BEACONS - lost - overtaken, sync.getBeaconCount());
+}
+
+void testSteadyClocks(void) {
+    runFollower(0ll, MIN_DELAY_MICROS, MAX_JITTER_MICROS, MIN_DELAY_MICROS + 5000ll);
+}
+
+void testLeaderClockFast(void) {
+    runFollower(30ll, MIN_DELAY_MICROS, MAX_JITTER_MICROS, MIN_DELAY_MICROS + 5000ll);
+}
+
+void testLeaderClockSlow(void) {
+    runFollower(-30ll, MIN_DELAY_MICROS, MAX_JITTER_MICROS, MIN_DELAY_MICROS + 5000ll);
+}
+
+void testLan(void) {
+    runFollower(30ll, LAN_MIN_DELAY_MICROS, LAN_MAX_JITTER_MICROS, LAN_MIN_DELAY_MICROS + 1000ll);
+    runFollower(-30ll, LAN_MIN_DELAY_MICROS, LAN_MAX_JITTER_MICROS, LAN_MIN_DELAY_MICROS + 1000ll);
+}
+
+void testLeaderLostAndRestarted(void) {
+    TimeSync sync;
+    uint8_t packet[TIME_SYNC_BEACON_SIZE];
+    uint64_t local = 1000000ull;
+    for (uint32_t beacon = 1u; beacon <= 10u; beacon++) {
+        TimeSync::writeBeacon(beacon, LEADER_START_MICROS + local, packet);
+        TEST_ASSERT_TRUE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, local + MIN_DELAY_MICROS));
+        local += TIME_SYNC_INTERVAL_MICROS;
+    }
+    TEST_ASSERT_TRUE(sync.isLocked(local));
+    TEST_ASSERT_FALSE(sync.isLocked(local + TIME_SYNC_TIMEOUT_MICROS));
+    uint64_t before = sync.toLeaderTime(local);
+
+    // The leader restarts, its clock and sequence begin again
+    local += TIME_SYNC_TIMEOUT_MICROS;
+    TimeSync::writeBeacon(1u, 500000ull, packet);
+    TEST_ASSERT_TRUE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, local));
+    TEST_ASSERT_TRUE(sync.isLocked(local));
+    TEST_ASSERT_EQUAL_UINT64(500000ull, sync.toLeaderTime(local));
+    TEST_ASSERT_TRUE(sync.toLeaderTime(local) < before);
+    TimeSync::writeBeacon(2u, 750000ull, packet);
+    TEST_ASSERT_TRUE(sync.readBeacon(packet, TIME_SYNC_BEACON_SIZE, local + TIME_SYNC_INTERVAL_MICROS));
+    TEST_ASSERT_EQUAL_UINT32(0ul, sync.getLostBeacons());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testBeaconFormat);
+    RUN_TEST(testSteadyClocks);
+    RUN_TEST(testLeaderClockFast);
+    RUN_TEST(testLeaderClockSlow);
+    RUN_TEST(testLan);
+    RUN_TEST(testLeaderLostAndRestarted);
+
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+/*
+  Timebase - Checks that time carries on across micros() wrapping every
+  71 minutes, and that effects keep stepping evenly across the wrap and
+  long after it.
+*/
+
+#include <unity.h>
+#include <Timebase.h>
+#include <Lighting.h>
+
+#define WRAP 0x100000000ull
+
+/**
+ * Keeps the last frame shown so the effect's output can be checked.
+ */
+class CapturingOutput : public LedOutput {
+    public:
+        CRGB frame[MAX_LEDS];
+        unsigned long shown = 0ul;
+
+        bool isBusy() override {
+            return false;
+        }
+
+        void show(const CRGB *frame, uint numLeds) override {
+            memcpy(this->frame, frame, numLeds * sizeof(CRGB));
+            shown++;
+        }
+};
+
+void setUp(void) {
+    Native::setMicros(0ull);
+}
+
+void tearDown(void) {}
+
+void testExtendAcrossWraps(void) {
+    Timebase timebase;
+    TEST_ASSERT_EQUAL_UINT64(0ull, timebase.extend(0ul));
+    TEST_ASSERT_EQUAL_UINT64(0xFFFFFFFFull, timebase.extend(0xFFFFFFFFul));
+    TEST_ASSERT_EQUAL_UINT64(WRAP, timebase.extend(0ul));
+    TEST_ASSERT_EQUAL_UINT64(WRAP + 5ull, timebase.extend(5ul));
+    TEST_ASSERT_EQUAL_UINT64(WRAP + 5ull, timebase.extend(5ul)); // The same reading twice isn't a wrap
+    TEST_ASSERT_EQUAL_UINT64(WRAP + 0x80000000ull, timebase.extend(0x80000000ul));
+    TEST_ASSERT_EQUAL_UINT64((2ull * WRAP) + 1ull, timebase.extend(1ul));
+}
+
+void testNowFollowsTheClock(void) {
+    Timebase timebase;
+    Native::setMicros(WRAP - 1000ull);
+    uint64_t last = timebase.now();
+    for (unsigned int i = 0u; i < 5000u; i++) { // Past three wraps, reading every 3.6 minutes
+        Native::advanceMicros(217000000ull + i);
+        uint64_t now = timebase.now();
+        TEST_ASSERT_EQUAL_UINT64(Native::clockMicros, now);
+        TEST_ASSERT_TRUE(now > last);
+        last = now;
+    }
+}
+
+void testEffectStepsAcrossTheWrap(void) {
+    const uint NUM_LEDS = 7u;
+    const ulong STEP_MICROS = 1000ul;
+    static CRGB frames[NUM_LEDS * 3u];
+    CapturingOutput output;
+    EffectEngine engine;
+    engine.begin(frames, NUM_LEDS, &output);
+    engine.setFreeRunning(true); // Steps count from time zero, as when synced
+    engine.setEffect(EFFECT_ONE_DIRECTION_CHASE);
+    engine.setStepMicros(STEP_MICROS);
+    engine.setPalette({{CRGB(0xFF0000ul), CRGB(0x00FF00ul)}, 2u, nullptr});
+
+    Timebase timebase;
+    Native::setMicros(WRAP - (50ull * STEP_MICROS));
+    for (unsigned int frame = 0u; frame < 100u; frame++) {
+        uint64 now = timebase.now();
+        TEST_ASSERT_TRUE(engine.service(now));
+        uint64 step = now / STEP_MICROS;
+        for (uint i = 0u; i < NUM_LEDS; i++) {
+            CRGB expected = (i == step % NUM_LEDS ? CRGB((step / NUM_LEDS) % 2u == 0u ? 0xFF0000ul : 0x00FF00ul) : CRGB(CRGB::Black));
+            TEST_ASSERT_TRUE(output.frame[i] == expected);
+        }
+        Native::advanceMicros(STEP_MICROS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100ul, output.shown);
+}
+
+void testStepBeyond32Bits(void) {
+    const uint NUM_LEDS = 13u;
+    CRGB frame[NUM_LEDS];
+    Palette palette = {{CRGB(0xFF0000ul), CRGB(0x00FF00ul), CRGB(0x0000FFul)}, 3u, nullptr};
+    FrameTime time = {0ull, 0ull, 0u};
+    for (uint64 step : {0xFFFFFFFFull, 0x100000000ull, 0x100000005ull, 0x123456789ABull}) {
+        time.step = step;
+        oneDirectionChaseEffect.render(frame, NUM_LEDS, time, palette);
+        for (uint i = 0u; i < NUM_LEDS; i++) {
+            CRGB expected = (i == step % NUM_LEDS ? palette.colors[(step / NUM_LEDS) % 3u] : CRGB(CRGB::Black));
+            TEST_ASSERT_TRUE(frame[i] == expected);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testExtendAcrossWraps);
+    RUN_TEST(testNowFollowsTheClock);
+    RUN_TEST(testEffectStepsAcrossTheWrap);
+    RUN_TEST(testStepBeyond32Bits);
+
+    return UNITY_END();
+}
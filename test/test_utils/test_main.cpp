@@ -0,0 +1,124 @@
+/*
+  Utils - Checks the hex and color codec against every byte value, both
+  cases of digit and the ways a color or list of colors can be malformed,
+  and that lists of colors read back the same as they were written.
+*/
+
+#include <unity.h>
+#include <Utils.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void testByteRoundTrip(void) {
+    for (unsigned int value = 0u; value < 256u; value++) {
+        char hex[3] = {'\0', '\0', '\0'};
+        Utils::decimalTo8BitHex(value, hex);
+        char expected[3];
+        snprintf(expected, sizeof(expected), "%02x", value);
+        TEST_ASSERT_EQUAL_STRING(expected, hex);
+
+        uint8 dec = 0u;
+        TEST_ASSERT_TRUE(Utils::hexTo8BitDecimal(hex, dec));
+        TEST_ASSERT_EQUAL_UINT8(value, dec);
+
+        snprintf(expected, sizeof(expected), "%02X", value);
+        dec = 0u;
+        TEST_ASSERT_TRUE(Utils::hexTo8BitDecimal(expected, dec));
+        TEST_ASSERT_EQUAL_UINT8(value, dec);
+    }
+}
+
+void testInvalidDigits(void) {
+    const char *INVALID[] = {"", "0", "g0", "0g", "0x", " 1", "1 ", "-1", "G0", "/0", ":0", "@0", "`0"};
+    for (const char *hex : INVALID) {
+        uint8 dec = 0x5Au;
+        TEST_ASSERT_FALSE_MESSAGE(Utils::hexTo8BitDecimal(hex, dec), hex);
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(0x5Au, dec, hex);
+    }
+}
+
+void testColors(void) {
+    char hex[7];
+    Utils::rgbDecimalsToHex(0x12u, 0xABu, 0x00u, hex);
+    TEST_ASSERT_EQUAL_STRING("12ab00", hex);
+    Utils::rgbDecimalToHex(0xFF00FFul, hex);
+    TEST_ASSERT_EQUAL_STRING("ff00ff", hex);
+
+    uint32 rgb = 0ul;
+    TEST_ASSERT_TRUE(Utils::rgbHexToDecimal("0A0b0C", rgb));
+    TEST_ASSERT_EQUAL_HEX32(0x0A0B0Cul, rgb);
+    TEST_ASSERT_TRUE(Utils::rgbHexToDecimal("ffffff trailing", rgb));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFul, rgb);
+
+    rgb = 0x123456ul;
+    TEST_ASSERT_FALSE(Utils::rgbHexToDecimal("", rgb));
+    TEST_ASSERT_FALSE(Utils::rgbHexToDecimal("fffff", rgb));
+    TEST_ASSERT_FALSE(Utils::rgbHexToDecimal("#ffffff", rgb));
+    TEST_ASSERT_FALSE(Utils::rgbHexToDecimal("fffffg", rgb));
+    TEST_ASSERT_EQUAL_HEX32(0x123456ul, rgb);
+}
+
+void testColorLists(void) {
+    uint32 rgbs[3] = {0ul, 0ul, 0ul};
+    TEST_ASSERT_EQUAL_UINT(3u, Utils::parseRgbHexList("ff0000:00ff00:0000ff", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000ul, rgbs[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x00FF00ul, rgbs[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x0000FFul, rgbs[2]);
+
+    TEST_ASSERT_EQUAL_UINT(2u, Utils::parseRgbHexList("010203:040506:070809", ':', rgbs, 2u));
+    TEST_ASSERT_EQUAL_UINT(1u, Utils::parseRgbHexList("010203", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(1u, Utils::parseRgbHexList("010203,040506", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(1u, Utils::parseRgbHexList("010203:04050", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(2u, Utils::parseRgbHexList("010203:040506:", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(0u, Utils::parseRgbHexList("", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(0u, Utils::parseRgbHexList("zz0000", ':', rgbs, 3u));
+    TEST_ASSERT_EQUAL_UINT(0u, Utils::parseRgbHexList("ff0000", ':', rgbs, 0u));
+}
+
+void testColorListRoundTrip(void) {
+    const uint32 RGBS[] = {0x000000ul, 0xFFFFFFul, 0x12AB0Ful, 0x800001ul};
+    char list[4u * 7u];
+    TEST_ASSERT_EQUAL_size_t(27u, Utils::formatRgbHexList(RGBS, 4u, ':', list, sizeof(list)));
+    TEST_ASSERT_EQUAL_STRING("000000:ffffff:12ab0f:800001", list);
+
+    uint32 rgbs[4] = {0ul, 0ul, 0ul, 0ul};
+    TEST_ASSERT_EQUAL_UINT(4u, Utils::parseRgbHexList(list, ':', rgbs, 4u));
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(RGBS, rgbs, 4u);
+
+    for (uint32 rgb = 0ul; rgb <= 0xFFFFFFul; rgb += 0x010101ul) { // Every byte value in each channel
+        uint32 pair[2] = {rgb, rgb ^ 0xFFFFFFu};
+        char text[14];
+        Utils::formatRgbHexList(pair, 2u, ',', text, sizeof(text));
+        uint32 read[2];
+        TEST_ASSERT_EQUAL_UINT(2u, Utils::parseRgbHexList(text, ',', read, 2u));
+        TEST_ASSERT_EQUAL_HEX32_ARRAY(pair, read, 2u);
+    }
+
+    // Only whole colors are written when the list is short of room
+    TEST_ASSERT_EQUAL_size_t(13u, Utils::formatRgbHexList(RGBS, 4u, ':', list, 20u));
+    TEST_ASSERT_EQUAL_STRING("000000:ffffff", list);
+    TEST_ASSERT_EQUAL_size_t(0u, Utils::formatRgbHexList(RGBS, 4u, ':', list, 6u));
+    TEST_ASSERT_EQUAL_STRING("", list);
+    TEST_ASSERT_EQUAL_size_t(0u, Utils::formatRgbHexList(RGBS, 0u, ':', list, sizeof(list)));
+    TEST_ASSERT_EQUAL_STRING("", list);
+}
+
+void testDeviceId(void) {
+    TEST_ASSERT_EQUAL_STRING("d41d8cd98f00b204e9800998ecf8427e", Utils::hashString("").c_str());
+    // The last six digits of the MD5 of the MAC address, in uppercase
+    TEST_ASSERT_EQUAL_STRING("F161D0", Utils::genDeviceIdFromMacAddr("message digest").c_str()); // f96b697d7cb7938d525a2f31aaf161d0
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testByteRoundTrip);
+    RUN_TEST(testInvalidDigits);
+    RUN_TEST(testColors);
+    RUN_TEST(testColorLists);
+    RUN_TEST(testColorListRoundTrip);
+    RUN_TEST(testDeviceId);
+
+    return UNITY_END();
+}
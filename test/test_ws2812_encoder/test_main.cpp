@@ -0,0 +1,115 @@
+/*
+  Ws2812Encoder - Checks the encoding against fixed bitstreams and by
+  playing each UART byte back as the level of the inverted data line,
+  which must give the WS2812 bits of the color byte it came from.
+*/
+
+#include <unity.h>
+#include <Ws2812Encoder.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/**
+ * Works out the data line for a UART byte sent 6N1 with the line
+ * inverted: the start bit high, the 6 data bits least significant
+ * first and inverted, then the stop bit low.
+ */
+void lineLevels(uint8_t uartByte, bool *levels) {
+    levels[0] = true;
+    for (unsigned int bit = 0u; bit < 6u; bit++) {
+        levels[1u + bit] = ((uartByte >> bit) & 0x01u) == 0u;
+    }
+    levels[7] = false;
+}
+
+/**
+ * Reads the two WS2812 bits carried by a UART byte, each is 4 bit times
+ * which must be high then low, high for 1 bit time for a 0 and for 3
+ * for a 1.
+ * 
+ * @return Returns the two bits or -1 if the waveform isn't valid.
+ */
+int decodeUartByte(uint8_t uartByte) {
+    bool levels[8];
+    lineLevels(uartByte, levels);
+    int bits = 0;
+    for (unsigned int half = 0u; half < 2u; half++) {
+        const bool *time = &levels[half * 4u];
+        unsigned int high = 0u;
+        while (high < 4u && time[high]) {
+            high++;
+        }
+        for (unsigned int t = high; t < 4u; t++) {
+            if (time[t]) {
+                return -1;
+            }
+        }
+        if (high != 1u && high != 3u) {
+            return -1;
+        }
+        bits = (bits << 1) | (high == 3u ? 1 : 0);
+    }
+
+    return bits;
+}
+
+void testGoldenBytes(void) {
+    const uint8_t CASES[][5] = {
+        // Color byte, then its four UART bytes
+        {0x00, 0x37, 0x37, 0x37, 0x37},
+        {0xFF, 0x04, 0x04, 0x04, 0x04},
+        {0xA5, 0x34, 0x34, 0x07, 0x07},
+        {0x1B, 0x37, 0x07, 0x34, 0x04},
+        {0x80, 0x34, 0x37, 0x37, 0x37},
+        {0x01, 0x37, 0x37, 0x37, 0x07}
+    };
+    for (const uint8_t *c : CASES) {
+        uint8_t out[4];
+        Ws2812Encoder::encodeByte(c[0], out);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(&c[1], out, 4u);
+    }
+}
+
+void testEveryByteDecodes(void) {
+    for (unsigned int value = 0u; value < 256u; value++) {
+        uint8_t out[4];
+        Ws2812Encoder::encodeByte(value, out);
+        unsigned int decoded = 0u;
+        for (unsigned int i = 0u; i < 4u; i++) {
+            int bits = decodeUartByte(out[i]);
+            TEST_ASSERT_TRUE(bits >= 0);
+            decoded = (decoded << 2) | bits;
+        }
+        TEST_ASSERT_EQUAL_UINT8(value, decoded);
+    }
+}
+
+void testPixelsInChannelOrder(void) {
+    const uint8_t PIXELS[] = {0x12, 0x34, 0x56, 0xFF, 0x00, 0x80};
+    const uint8_t GRB[] = {1u, 0u, 2u};
+    uint8_t out[2u * WS2812_UART_BYTES_PER_PIXEL + 1u];
+    out[sizeof(out) - 1u] = 0xEEu;
+    Ws2812Encoder::encode(PIXELS, 2u, GRB, out);
+
+    const uint8_t SENT[] = {0x34, 0x12, 0x56, 0x00, 0xFF, 0x80}; // Green, red, blue of each
+    for (unsigned int i = 0u; i < sizeof(SENT); i++) {
+        uint8_t expected[4];
+        Ws2812Encoder::encodeByte(SENT[i], expected);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, &out[i * 4u], 4u);
+    }
+    TEST_ASSERT_EQUAL_HEX8(0xEEu, out[sizeof(out) - 1u]);
+
+    const uint8_t GOLDEN[WS2812_UART_BYTES_PER_PIXEL] = {0x37, 0x04, 0x07, 0x37, 0x37, 0x07, 0x37, 0x34, 0x07, 0x07, 0x07, 0x34};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(GOLDEN, out, WS2812_UART_BYTES_PER_PIXEL);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(testGoldenBytes);
+    RUN_TEST(testEveryByteDecodes);
+    RUN_TEST(testPixelsInChannelOrder);
+
+    return UNITY_END();
+}
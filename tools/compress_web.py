@@ -0,0 +1,79 @@
+"""
+  compress_web - Gzips the static files of the web UI in web/ into
+  include/WebAssets.h so they can be served from PROGMEM as they are.
+  PlatformIO runs this before each build, see extra_scripts in
+  platformio.ini, and it can also be run by hand. The header is only
+  rewritten when the files have changed.
+
+  Written by: ... Scott Griffis
+  Date: ......... 10-16-2026
+"""
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# The files to compress and the name each is given in the header
+ASSETS = [
+    ("index.html", "INDEX_HTML"),
+]
+
+HEADER = os.path.join(PROJECT_DIR, "include", "WebAssets.h")
+
+
+def compress_asset(file_name, name):
+    with open(os.path.join(PROJECT_DIR, "web", file_name), "rb") as source:
+        data = source.read()
+
+    # A fixed mtime keeps the output, and so the ETag, the same for the same file
+    compressed = gzip.compress(data, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(compressed).hexdigest()[:16]
+
+    lines = [
+        "    // web/%s, %d bytes before compression" % (file_name, len(data)),
+        "    const char %s_ETAG[] = \"\\\"%s\\\"\";" % (name, etag),
+        "    const size_t %s_GZ_SIZE = %du;" % (name, len(compressed)),
+        "    const uint8_t %s_GZ[] PROGMEM = {" % name,
+    ]
+    for i in range(0, len(compressed), 16):
+        row = ", ".join("0x%02x" % b for b in compressed[i:i + 16])
+        lines.append("        " + row + ("," if i + 16 < len(compressed) else ""))
+    lines.append("    };")
+
+    return "\n".join(lines)
+
+
+def main():
+    header = "\n".join([
+        "/*",
+        "  WebAssets - The static files of the web UI, gzipped. Generated from",
+        "  web/ by tools/compress_web.py before each build, do not edit.",
+        "*/",
+        "",
+        "#ifndef WebAssets_h",
+        "    #define WebAssets_h",
+        "",
+        "    #include <stddef.h>",
+        "    #include <pgmspace.h>",
+        "",
+        "\n\n".join(compress_asset(file_name, name) for file_name, name in ASSETS),
+        "#endif",
+        "",
+    ])
+
+    current = None
+    if os.path.exists(HEADER):
+        with open(HEADER, "r") as existing:
+            current = existing.read()
+    if header != current:
+        with open(HEADER, "w") as output:
+            output.write(header)
+
+
+main()